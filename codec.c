@@ -0,0 +1,82 @@
+#include "codec.h"
+
+#include "engine.h"
+
+void state_codec_init(StateCodec* codec, PlayGround* start) {
+    uint8_t x, y, tile, types;
+    uint8_t ofBrick[WALL_TILE];
+
+    memset(codec, '\0', sizeof(StateCodec));
+
+    for(y = 0; y < SIZE_Y; y++) {
+        for(x = 0; x < SIZE_X; x++) {
+            if((*start)[y][x] == WALL_TILE) {
+                codec->walls[y][x] = WALL_TILE;
+            } else {
+                codec->cells[codec->cellCount++] = y * SIZE_X + x;
+            }
+        }
+    }
+
+    // palette of types present, code 0 stays for empty cells
+    count_bricks(start, ofBrick);
+    types = 1;
+    for(tile = 1; tile < WALL_TILE; tile++) {
+        if(ofBrick[tile] > 0) {
+            codec->toCode[tile] = types;
+            codec->toTile[types] = tile;
+            types++;
+        }
+    }
+
+    codec->bits = 1;
+    while((1 << codec->bits) < types) {
+        codec->bits++;
+    }
+    codec->keySize = (codec->cellCount * codec->bits + 7) / 8;
+}
+
+//-----------------------------------------------------------------------------
+
+void encode_state(const StateCodec* codec, PlayGround* pg, uint8_t* key) {
+    const uint8_t* board = (*pg)[0];
+    uint16_t acc = 0;
+    uint8_t accBits = 0;
+    uint8_t i;
+
+    for(i = 0; i < codec->cellCount; i++) {
+        acc |= codec->toCode[board[codec->cells[i]]] << accBits;
+        accBits += codec->bits;
+        if(accBits >= 8) {
+            *key++ = acc & 0xFF;
+            acc >>= 8;
+            accBits -= 8;
+        }
+    }
+
+    // unused high bits stay zero, keys are compared bytewise
+    if(accBits > 0) {
+        *key = acc & 0xFF;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void decode_state(const StateCodec* codec, const uint8_t* key, PlayGround* pg) {
+    uint8_t* board = (*pg)[0];
+    const uint8_t mask = (1 << codec->bits) - 1;
+    uint16_t acc = 0;
+    uint8_t accBits = 0;
+    uint8_t i;
+
+    memcpy(pg, codec->walls, sizeof(PlayGround));
+    for(i = 0; i < codec->cellCount; i++) {
+        if(accBits < codec->bits) {
+            acc |= *key++ << accBits;
+            accBits += 8;
+        }
+        board[codec->cells[i]] = codec->toTile[acc & mask];
+        acc >>= codec->bits;
+        accBits -= codec->bits;
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "common.h"
+
+// Compact keys for board states of one level, for visited sets and caches.
+//
+// Walls never change within a level and brick types can only disappear, so
+// a key stores just the cells that are not walls, each as an index into the
+// palette of types present at the start (0 = empty). Bits per cell depend
+// on the number of types: three types fit in 2 bits, eight in 4 bits, so a
+// key never takes more than STATE_KEY_MAX bytes, against 80 of PlayGround.
+
+#define STATE_KEY_MAX (SIZE_X * SIZE_Y / 2)
+
+typedef struct {
+    PlayGround walls;
+    uint8_t cells[SIZE_X * SIZE_Y];
+    uint8_t cellCount;
+    uint8_t bits;
+    uint8_t keySize;
+    uint8_t toCode[WALL_TILE];
+    uint8_t toTile[WALL_TILE];
+} StateCodec;
+
+//-----------------------------------------------------------------------------
+
+void state_codec_init(StateCodec* codec, PlayGround* start);
+void encode_state(const StateCodec* codec, PlayGround* pg, uint8_t* key);
+void decode_state(const StateCodec* codec, const uint8_t* key, PlayGround* pg);
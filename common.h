@@ -14,11 +14,24 @@
 #define WALL_TILE 9
 #define EMPTY_TILE 0
 
-#define MENU_PAUSED_COUNT 6
+#define MENU_PAUSED_COUNT 8
 #define MAIN_MENU_COUNT 3
 
 #define PAR_LABEL_SIZE 10
 
+// -- simulation -----------
+
+#define SIM_STEPS_PER_SECOND 20
+#define IDLE_FRAMES_PER_SECOND 4 // redraw rate while waiting for player
+// steps run for one late tick, rest is dropped; covers a whole idle frame
+#define SIM_MAX_CATCHUP (SIM_STEPS_PER_SECOND / IDLE_FRAMES_PER_SECOND)
+
+#define SOLUTION_SPEEDS 4 // waits of 70, 35, 16 and 8 steps before each solution move
+#define SOLUTION_SPEED_NORMAL 1
+#define FLASH_STEPS 3 // exploded cells shown after instant move
+
+#define INPUT_AHEAD_SIZE 16 // keys pressed while animating, replayed after
+
 // -- move -----------------
 
 #define MOVABLE_NOT 0
@@ -4,6 +4,7 @@
 #include <gui/icon.h>
 #include <gui/elements.h>
 #include <gui/icon_i.h>
+#include <gui/canvas_i.h>
 #include "fonts.h"
 #include "game_vexed_icons.h"
 #include "ui.h"
@@ -12,144 +13,186 @@
 
 //-----------------------------------------------------------------------------
 
-u_int32_t frameNo = 0;
-int r1 = 0, r2 = 0;
-
-//-----------------------------------------------------------------------------
-
-void draw_app(Canvas* canvas, Game* game) {
+void draw_app(Canvas* canvas, Renderer* render, RenderSnapshot* view) {
     canvas_clear(canvas);
 
-    if((game->state == MAIN_MENU) || (game->state == RESET_PROMPT)) {
-        draw_main_menu(canvas, game);
+    if((view->state == MAIN_MENU) || (view->state == RESET_PROMPT)) {
+        draw_main_menu(canvas, render, view);
     }
 
-    if(game->state == ABOUT) {
-        draw_about(canvas, game, frameNo);
+    if(view->state == ABOUT) {
+        draw_about(canvas, view);
     }
 
-    if(game->state == INTRO) {
-        draw_intro(canvas, game, frameNo);
+    if(view->state == INTRO) {
+        draw_intro(canvas, view);
     }
 
-    if(game->state == RESET_PROMPT) {
-        draw_reset_prompt(canvas, game);
+    if(view->state == RESET_PROMPT) {
+        draw_reset_prompt(canvas, view);
     }
 
-    if(game->state == INVALID_PROMPT) {
-        draw_invalid_prompt(canvas, game);
+    if(view->state == INVALID_PROMPT) {
+        draw_invalid_prompt(canvas, view);
     }
 
-    if(game->state >= SELECT_BRICK) {
-        draw_playground(canvas, game);
+    if(view->state >= SELECT_BRICK) {
+        update_board_icons(render, view);
+        draw_static_layer(canvas, render, view);
 
-        switch(game->state) {
+        switch(view->state) {
         case SELECT_BRICK:
-            draw_movable(canvas, game, frameNo);
+            draw_movable(canvas, view);
             break;
         case SOLUTION_SELECT:
-            draw_direction_solution(canvas, game, frameNo);
+            draw_direction_solution(canvas, view);
             break;
         case SELECT_DIRECTION:
-            draw_direction(canvas, game, frameNo);
+            draw_direction(canvas, view);
             break;
         case MOVE_SIDES:
-            draw_ani_sides(canvas, game);
+            draw_ani_sides(canvas, render, view);
             break;
         case MOVE_GRAVITY:
-            draw_ani_gravity(canvas, game);
+            draw_ani_gravity(canvas, render, view);
             break;
         case EXPLODE:
-            draw_ani_explode(canvas, game);
+            draw_ani_explode(canvas, render, view);
             break;
         default:
             break;
         }
 
-        draw_scores(canvas, game, frameNo);
-        draw_playfield_hint(canvas, game);
+        if(view->flashSteps > 0) {
+            draw_flash(canvas, view);
+        }
 
-        switch(game->state) {
+        switch(view->state) {
         case PAUSED:
-            draw_paused(canvas, game);
+            draw_paused(canvas, view);
             break;
         case HISTOGRAM:
-            draw_histogram(canvas, game->stats);
+            draw_histogram(canvas, view);
             break;
         case SOLUTION_PROMPT:
-            draw_solution_prompt(canvas, game);
+            draw_solution_prompt(canvas, view);
             break;
         case GAME_OVER:
-            draw_game_over(canvas, game->gameOverReason);
+            draw_game_over(canvas, view->gameOverReason);
             break;
         case LEVEL_FINISHED:
-            draw_level_finished(canvas, game);
+            draw_level_finished(canvas, view);
             break;
         default:
             break;
         }
     }
 
-    frameNo++;
+    if(view->profilerOverlay) {
+        draw_profiler(canvas, render, view);
+    }
 }
 
+
 //-----------------------------------------------------------------------------
 
-void draw_intro(Canvas* canvas, Game* game, uint32_t frameNo) {
-    if(frameNo % 2 == 1) {
-        if(game->move.frameNo < 100) game->move.frameNo++;
+void update_board_icons(Renderer* render, RenderSnapshot* view) {
+    const bool gameOver = (view->state == GAME_OVER);
+    BoardIcons* cache = &render->boardIcons;
+    uint8_t x, y;
+
+    if(cache->valid && (cache->rev == view->layerRev) && (cache->gameOver == gameOver)) {
+        return;
     }
 
+    const Icon* const* icons = tile_icons(gameOver);
+    for(y = 0; y < SIZE_Y; y++) {
+        for(x = 0; x < SIZE_X; x++) {
+            const uint8_t tile = view->board[y][x];
+            cache->icons[y][x] = (tile == EMPTY_TILE) ? NULL : icons[tile];
+        }
+    }
+
+    cache->rev = view->layerRev;
+    cache->gameOver = gameOver;
+    cache->valid = true;
+}
+
+//-----------------------------------------------------------------------------
+
+void draw_static_layer(Canvas* canvas, Renderer* render, RenderSnapshot* view) {
+    LayerKey key;
+    uint8_t* buffer = canvas_get_buffer(canvas);
+    furi_assert(canvas_get_buffer_size(canvas) == LAYER_BUFFER_SIZE);
+
+    memset(&key, 0, sizeof(LayerKey));
+    key.rev = view->layerRev;
+    key.state = view->state;
+    key.showScore = blink_phase(5000);
+    key.hintBoth = (view->currentMovable != MOVABLE_NOT_FOUND) &&
+                   (movable_dir(&view->movables, view->currentMovable) == MOVABLE_BOTH);
+    key.solutionStep = view->solutionStep;
+    key.solutionPaused = view->solutionPaused;
+    key.solutionSpeed = view->solutionSpeed;
+    key.gameMoves = view->gameMoves;
+    key.score = view->score;
+
+    if(render->layer.valid && (memcmp(&key, &render->layer.key, sizeof(LayerKey)) == 0)) {
+        memcpy(buffer, render->layer.buffer, LAYER_BUFFER_SIZE);
+        return;
+    }
+
+    // selection and animations are drawn on top, and never overlap score
+    // panel or hint with anything but black, so drawing order is preserved
+    draw_playground(canvas, render, view);
+    draw_scores(canvas, render, view);
+    draw_playfield_hint(canvas, view);
+
+    memcpy(render->layer.buffer, buffer, LAYER_BUFFER_SIZE);
+    memcpy(&render->layer.key, &key, sizeof(LayerKey));
+    render->layer.valid = true;
+}
+
+//-----------------------------------------------------------------------------
+
+void draw_intro(Canvas* canvas, RenderSnapshot* view) {
     canvas_set_color(canvas, ColorBlack);
-    if((game->move.frameNo < 12)) {
+    if((view->move.frameNo < 12)) {
+        const Icon* const* icons = tile_icons(false);
         uint8_t x, y;
         for(y = 0; y < SIZE_Y_BG; y++) {
             for(x = 0; x < SIZE_X_BG; x++) {
-                canvas_draw_icon(
-                    canvas, x * TILE_SIZE, y * TILE_SIZE, tile_to_icon(game->bg[y][x], false));
+                canvas_draw_icon(canvas, x * TILE_SIZE, y * TILE_SIZE, icons[view->bg[y][x]]);
             }
         }
     }
 
-    if((game->move.frameNo < 4)) {
+    if((view->move.frameNo < 4)) {
         gray_canvas(canvas);
     }
 
-    if(game->move.frameNo > 7) {
+    if(view->move.frameNo > 7) {
         canvas_set_color(canvas, ColorXOR);
         canvas_draw_box(canvas, 0, 0, GUI_DISPLAY_WIDTH, GUI_DISPLAY_HEIGHT);
         canvas_draw_icon(canvas, 0, 0, &I_logo_vexed_big);
     }
 
-    if(game->move.frameNo > 11) {
+    if(view->move.frameNo > 11) {
         canvas_set_color(canvas, ColorBlack);
         canvas_draw_icon(canvas, 0, 0, &I_logo_vexed_big);
     }
-
-    if(game->move.frameNo == 24) {
-        game->state = MAIN_MENU;
-    }
 }
 
-void draw_about(Canvas* canvas, Game* game, uint32_t frameNo) {
-    if(frameNo % 10 == 9) {
-        randomize_bg(&game->bg);
-    }
-
-    if(frameNo % 50 == 49) {
-        r1 = rand();
-        r2 = rand();
-        randomize_bg(&game->bg);
-    }
-
+void draw_about(Canvas* canvas, RenderSnapshot* view) {
+    const Icon* const* icons = tile_icons(false);
     uint8_t sx, sy;
     for(sy = 0; sy < SIZE_Y_BG; sy++) {
         for(sx = 0; sx < SIZE_X_BG; sx++) {
             canvas_draw_icon(
                 canvas,
-                (sx * TILE_SIZE) - (r1 % 7),
-                sy * TILE_SIZE - (r2 % 7),
-                tile_to_icon(game->bg[sy][sx], false));
+                (sx * TILE_SIZE) - view->bgShiftX,
+                sy * TILE_SIZE - view->bgShiftY,
+                icons[view->bg[sy][sx]]);
         }
     }
 
@@ -178,60 +221,47 @@ void draw_about(Canvas* canvas, Game* game, uint32_t frameNo) {
     elements_button_right_back(canvas, "Back");
 }
 
-void draw_set_info(Canvas* canvas, Game* game) {
+void draw_set_info(Canvas* canvas, Renderer* render, RenderSnapshot* view) {
     BoundingBox box;
     const uint8_t w = 118;
     const uint8_t h = 46;
     const uint8_t x = (GUI_DISPLAY_WIDTH - w) / 2;
 
-    const uint8_t y =
-        dialog_frame(canvas, w, h, false, false, furi_string_get_cstr(game->levelSet->title));
+    const uint8_t y = dialog_frame(canvas, w, h, false, false, view->setTitle);
 
     canvas_set_custom_u8g2_font(canvas, app_u8g2_font_squeezed_r6_tr);
     canvas_set_color(canvas, ColorBlack);
     canvas_draw_str_aligned(
-        canvas,
-        GUI_DISPLAY_WIDTH / 2,
-        y,
-        AlignCenter,
-        AlignTop,
-        furi_string_get_cstr(game->levelSet->author));
+        canvas, GUI_DISPLAY_WIDTH / 2, y, AlignCenter, AlignTop, view->setAuthor);
 
     canvas_draw_str_aligned(
-        canvas,
-        GUI_DISPLAY_WIDTH / 2,
-        y + 8,
-        AlignCenter,
-        AlignTop,
-        furi_string_get_cstr(game->levelSet->url));
+        canvas, GUI_DISPLAY_WIDTH / 2, y + 8, AlignCenter, AlignTop, view->setUrl);
 
     canvas_draw_hline_dotted(canvas, x, y + 16, w);
 
     set_bounding_box(&box, x + 3, y + 16, w - 6, 16);
     elements_multiline_text_aligned_limited(
         canvas,
+        &render->descriptionLayout,
+        view->setDescriptionRev,
         &box,
         box.width / 2,
         box.height / 2,
         2,
         AlignCenter,
         AlignCenter,
-        furi_string_get_cstr(game->levelSet->description));
+        app_u8g2_font_squeezed_r6_tr,
+        view->setDescription);
 }
 
 //-----------------------------------------------------------------------------
 
-void draw_level_info(Canvas* canvas, Game* game) {
+void draw_level_info(Canvas* canvas, RenderSnapshot* view) {
     int bufSize = 80;
     char buf[bufSize];
 
     memset(buf, 0, bufSize);
-    snprintf(
-        buf,
-        sizeof(buf),
-        "%s #%u",
-        furi_string_get_cstr(game->levelSet->title),
-        game->selectedLevel + 1);
+    snprintf(buf, sizeof(buf), "%s #%u", view->setTitle, view->selectedLevel + 1);
 
     const uint8_t x = (GUI_DISPLAY_WIDTH - 100) / 2;
     const uint8_t y = dialog_frame(canvas, 100, 40, false, false, buf);
@@ -243,20 +273,15 @@ void draw_level_info(Canvas* canvas, Game* game) {
     canvas_set_custom_u8g2_font(canvas, app_u8g2_font_squeezed_r7_tr);
     canvas_draw_str_aligned(canvas, x + 25, y + 4, AlignCenter, AlignTop, "Moves/Par");
     memset(buf, 0, bufSize);
-    if(game->levelSet->scores[game->selectedLevel].moves == 0) {
+    if(view->selectedMoves == 0) {
         snprintf(
             buf,
             sizeof(buf),
             "??? / %u",
 
-            game->levelSet->pars[game->selectedLevel]);
+            view->selectedPar);
     } else {
-        snprintf(
-            buf,
-            sizeof(buf),
-            "%u / %u",
-            game->levelSet->scores[game->selectedLevel].moves,
-            game->levelSet->pars[game->selectedLevel]);
+        snprintf(buf, sizeof(buf), "%u / %u", view->selectedMoves, view->selectedPar);
     }
     canvas_set_font(canvas, FontPrimary);
     canvas_draw_str_aligned(canvas, x + 25, y + 22, AlignCenter, AlignBottom, buf);
@@ -264,10 +289,10 @@ void draw_level_info(Canvas* canvas, Game* game) {
     canvas_set_custom_u8g2_font(canvas, app_u8g2_font_squeezed_r7_tr);
     canvas_draw_str_aligned(canvas, x + 75, y + 4, AlignCenter, AlignTop, "Score");
     memset(buf, 0, bufSize);
-    if(game->score == 0) {
+    if(view->score == 0) {
         snprintf(buf, sizeof(buf), "on par");
     } else {
-        snprintf(buf, sizeof(buf), "%+d", game->score);
+        snprintf(buf, sizeof(buf), "%+d", view->score);
     }
     canvas_set_font(canvas, FontPrimary);
     canvas_draw_str_aligned(canvas, x + 75, y + 22, AlignCenter, AlignBottom, buf);
@@ -275,11 +300,11 @@ void draw_level_info(Canvas* canvas, Game* game) {
 
 //-----------------------------------------------------------------------------
 
-void draw_main_menu_new_game(Canvas* canvas, Game* game) {
+void draw_main_menu_new_game(Canvas* canvas, RenderSnapshot* view) {
     canvas_set_color(canvas, ColorBlack);
     canvas_set_font(canvas, FontSecondary);
     elements_button_center(canvas, "Start");
-    if(game->hasContinue) {
+    if(view->hasContinue) {
         canvas_set_custom_u8g2_font(canvas, app_u8g2_font_squeezed_r7_tr);
         elements_button_right(canvas, "Continue");
         canvas_draw_str_aligned(
@@ -294,18 +319,18 @@ void draw_main_menu_new_game(Canvas* canvas, Game* game) {
 
 //-----------------------------------------------------------------------------
 
-void draw_main_menu_continue(Canvas* canvas, Game* game) {
+void draw_main_menu_continue(Canvas* canvas, RenderSnapshot* view) {
     int bufSize = 80;
     char buf[bufSize];
     int scorebufSize = 10;
     char scorebufSet[scorebufSize];
-    bool hasNext = (game->continueLevel + 1) < game->levelSet->maxLevel;
+    bool hasNext = (view->continueLevel + 1) < view->maxLevel;
     memset(scorebufSet, 0, scorebufSize);
 
-    if(game->score == 0) {
+    if(view->score == 0) {
         snprintf(scorebufSet, sizeof(scorebufSet), "par");
     } else {
-        snprintf(scorebufSet, sizeof(scorebufSet), "%+d", game->score);
+        snprintf(scorebufSet, sizeof(scorebufSet), "%+d", view->score);
     }
 
     canvas_set_color(canvas, ColorBlack);
@@ -321,11 +346,11 @@ void draw_main_menu_continue(Canvas* canvas, Game* game) {
             buf,
             sizeof(buf),
             "%s (%s), #%d",
-            furi_string_get_cstr(game->continueSet),
+            view->continueSet,
             scorebufSet,
-            game->continueLevel + 2);
+            view->continueLevel + 2);
     } else {
-        snprintf(buf, sizeof(buf), "%s finished!", furi_string_get_cstr(game->continueSet));
+        snprintf(buf, sizeof(buf), "%s finished!", view->continueSet);
     }
 
     canvas_draw_str_aligned(canvas, GUI_DISPLAY_CENTER_X, 37, AlignCenter, AlignTop, buf);
@@ -333,26 +358,20 @@ void draw_main_menu_continue(Canvas* canvas, Game* game) {
 
 //-----------------------------------------------------------------------------
 
-void draw_main_menu_custom(Canvas* canvas, Game* game) {
+void draw_main_menu_custom(Canvas* canvas, RenderSnapshot* view) {
     int bufSize = 80;
     char buf[bufSize];
 
-    int scorebufSize = 10;
-    char scorebuf[scorebufSize];
-
     canvas_set_color(canvas, ColorBlack);
     canvas_set_custom_u8g2_font(canvas, app_u8g2_font_squeezed_r7_tr);
     main_menu_pill(
         canvas,
         35,
         90,
-        game->mainMenuBtn == LEVELSET_BTN,
-        game->setPos > 0,
-        game->setPos < game->setCount - 1,
-        furi_string_get_cstr(game->selectedSet));
-
-    memset(scorebuf, 0, scorebufSize);
-    score_for_level(game, game->selectedLevel, scorebuf, scorebufSize);
+        view->mainMenuBtn == LEVELSET_BTN,
+        view->setPos > 0,
+        view->setPos < view->setCount - 1,
+        view->selectedSet);
 
     canvas_set_font(canvas, FontSecondary);
     memset(buf, 0, bufSize);
@@ -360,22 +379,22 @@ void draw_main_menu_custom(Canvas* canvas, Game* game) {
         buf,
         sizeof(buf),
         "%u of %u (%s)",
-        game->selectedLevel + 1,
-        game->levelSet->maxLevel,
-        scorebuf);
+        view->selectedLevel + 1,
+        view->maxLevel,
+        view->selectedScore);
     main_menu_pill(
         canvas,
         50,
         90,
-        game->mainMenuBtn == LEVELNO_BTN,
-        game->selectedLevel > 0,
-        game->selectedLevel < game->levelSet->maxLevel - 1,
+        view->mainMenuBtn == LEVELNO_BTN,
+        view->selectedLevel > 0,
+        view->selectedLevel < view->maxLevel - 1,
         buf);
 }
 
 //-----------------------------------------------------------------------------
 
-void draw_main_menu(Canvas* canvas, Game* game) {
+void draw_main_menu(Canvas* canvas, Renderer* render, RenderSnapshot* view) {
     canvas_set_color(canvas, ColorBlack);
 
     canvas_draw_line(canvas, 0, 6, GUI_DISPLAY_WIDTH, 6);
@@ -391,31 +410,31 @@ void draw_main_menu(Canvas* canvas, Game* game) {
         canvas,
         20,
         90,
-        game->mainMenuBtn == MODE_BTN,
-        game->mainMenuMode != NEW_GAME,
-        game->mainMenuMode != CUSTOM,
-        game_mode_label(game->mainMenuMode));
+        view->mainMenuBtn == MODE_BTN,
+        view->mainMenuMode != NEW_GAME,
+        view->mainMenuMode != CUSTOM,
+        game_mode_label(view->mainMenuMode));
 
-    switch(game->mainMenuMode) {
+    switch(view->mainMenuMode) {
     case CONTINUE:
-        draw_main_menu_continue(canvas, game);
+        draw_main_menu_continue(canvas, view);
         break;
     case CUSTOM:
-        draw_main_menu_custom(canvas, game);
+        draw_main_menu_custom(canvas, view);
         break;
     case NEW_GAME:
     default:
-        draw_main_menu_new_game(canvas, game);
+        draw_main_menu_new_game(canvas, view);
         break;
     }
 
-    if(game->mainMenuInfo) {
+    if(view->mainMenuInfo) {
         gray_canvas(canvas);
 
-        if(game->mainMenuBtn == LEVELSET_BTN) {
-            draw_set_info(canvas, game);
-        } else if(game->mainMenuBtn == LEVELNO_BTN) {
-            draw_level_info(canvas, game);
+        if(view->mainMenuBtn == LEVELSET_BTN) {
+            draw_set_info(canvas, render, view);
+        } else if(view->mainMenuBtn == LEVELNO_BTN) {
+            draw_level_info(canvas, view);
         }
 
         canvas_set_color(canvas, ColorBlack);
@@ -427,133 +446,58 @@ void draw_main_menu(Canvas* canvas, Game* game) {
 
 //-----------------------------------------------------------------------------
 
-void draw_playground(Canvas* canvas, Game* game) {
-    Neighbors tiles;
-    uint8_t tile, x, y, sx, sy, ex, ey;
+void draw_wall_outline(Canvas* canvas, WallOutline* outline) {
+    WallSegment* seg = outline->segments;
+
+    canvas_set_color(canvas, ColorBlack);
+    for(uint16_t i = 0; i < outline->blackCount + outline->whiteCount; i++, seg++) {
+        if(i == outline->blackCount) canvas_set_color(canvas, ColorWhite);
+        if((seg->x0 == seg->x1) && (seg->y0 == seg->y1)) {
+            canvas_draw_dot(canvas, seg->x0, seg->y0);
+        } else {
+            canvas_draw_line(canvas, seg->x0, seg->y0, seg->x1, seg->y1);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void draw_playground(Canvas* canvas, Renderer* render, RenderSnapshot* view) {
+    uint8_t x, y, sx, sy;
+    const Icon* icon;
 
-    bool whiteB = (game->state == LEVEL_FINISHED) || (game->solutionMode);
+    bool whiteB = (view->state == LEVEL_FINISHED) || (view->solutionMode);
+    const bool skipSliding = (view->state == MOVE_SIDES);
+    const bool skipAnimated = (view->state == MOVE_GRAVITY) || (view->state == EXPLODE);
 
+    canvas_set_color(canvas, ColorBlack);
     for(y = 0; y < SIZE_Y; y++) {
         for(x = 0; x < SIZE_X; x++) {
-            tile = game->board[y][x];
+            icon = render->boardIcons.icons[y][x];
+            if(icon == NULL) continue;
 
             sx = x * TILE_SIZE;
             sy = y * TILE_SIZE;
-            ex = ((x + 1) * TILE_SIZE) - 1;
-            ey = ((y + 1) * TILE_SIZE) - 1;
-
-            if(tile > 0) {
-                if((game->state == MOVE_SIDES) && (x == game->move.x) && (y == game->move.y))
-                    continue;
-                if(((game->state == MOVE_GRAVITY) || (game->state == EXPLODE)) &&
-                   (game->toAnimate[y][x] == 1))
-                    continue;
-
-                canvas_set_color(canvas, ColorBlack);
-                canvas_draw_icon(canvas, sx, sy, tile_to_icon(tile, game->state == GAME_OVER));
-            }
-            if(tile == WALL_TILE) {
-                tiles = find_neighbors(&game->board, x, y);
-
-                // UP
-                if(tiles.u != WALL_TILE) {
-                    canvas_set_color(canvas, ColorBlack);
-                    canvas_draw_line(canvas, sx, sy + 1, ex, sy + 1);
-
-                    canvas_set_color(canvas, ColorWhite);
-                    canvas_draw_line(canvas, sx, sy, ex, sy);
-                    if(whiteB) canvas_draw_line(canvas, sx, sy + 2, ex, sy + 2);
-                }
-
-                // DOWN
-                if(tiles.d != WALL_TILE) {
-                    canvas_set_color(canvas, ColorBlack);
-                    canvas_draw_line(canvas, sx, ey, ex, ey);
-                    canvas_set_color(canvas, ColorWhite);
-                    if(whiteB) canvas_draw_line(canvas, sx, ey - 1, ex, ey - 1);
-                }
 
-                // LEFT
-                if(tiles.l != WALL_TILE) {
-                    canvas_set_color(canvas, ColorBlack);
-                    canvas_draw_line(
-                        canvas, sx + 1, sy + ((tiles.u != WALL_TILE) ? 1 : 0), sx + 1, ey);
-
-                    canvas_set_color(canvas, ColorWhite);
-                    canvas_draw_line(canvas, sx, sy, sx, ey);
-                    if(whiteB)
-                        canvas_draw_line(
-                            canvas,
-                            sx + 2,
-                            sy + ((tiles.u != WALL_TILE) ? 2 : 0),
-                            sx + 2,
-                            ey - ((tiles.d != WALL_TILE) ? 2 : 0));
-                }
-
-                // RIGHT
-                if(tiles.r != WALL_TILE) {
-                    canvas_set_color(canvas, ColorBlack);
-                    canvas_draw_line(canvas, ex, (sy) + ((tiles.u != WALL_TILE) ? 1 : 0), ex, ey);
-                    canvas_set_color(canvas, ColorWhite);
-                    if(whiteB)
-                        canvas_draw_line(
-                            canvas,
-                            ex - 1,
-                            sy + ((tiles.u != WALL_TILE) ? 2 : 0),
-                            ex - 1,
-                            ey - ((tiles.d != WALL_TILE) ? 2 : 0));
-                }
-
-                if((tiles.dl != WALL_TILE) && (tiles.l == WALL_TILE)) {
-                    canvas_set_color(canvas, ColorBlack);
-                    canvas_draw_line(canvas, sx, ey, sx + 1, ey);
-                    canvas_set_color(canvas, ColorWhite);
-                    if(whiteB) canvas_draw_line(canvas, sx, ey - 1, sx + 2, ey - 1);
-                }
+            if(skipSliding && (x == view->move.x) && (y == view->move.y)) continue;
+            if(skipAnimated && (view->toAnimate[y][x] == 1)) continue;
 
-                if((tiles.ur != WALL_TILE) && (tiles.u == WALL_TILE)) {
-                    canvas_set_color(canvas, ColorBlack);
-                    canvas_draw_line(canvas, ex, sy, ex, sy + 1);
-                    canvas_set_color(canvas, ColorWhite);
-                    if(whiteB) canvas_draw_line(canvas, ex - 1, sy, ex - 1, sy + 2);
-                }
-
-                if(tiles.ul != WALL_TILE) {
-                    canvas_set_color(canvas, ColorWhite);
-                    canvas_draw_dot(canvas, sx, sy);
-                    if(whiteB) canvas_draw_dot(canvas, sx + 2, sy + 2);
-                    if(tiles.l == WALL_TILE) {
-                        canvas_set_color(canvas, ColorBlack);
-                        canvas_draw_line(canvas, sx, sy + 1, sx + 1, sy + 1);
-                        canvas_set_color(canvas, ColorWhite);
-                        if(whiteB) canvas_draw_line(canvas, sx, sy + 2, sx + 1, sy + 2);
-                    }
-                    if(tiles.u == WALL_TILE) {
-                        canvas_set_color(canvas, ColorBlack);
-                        canvas_draw_line(canvas, sx + 1, sy, sx + 1, sy + 1);
-                        canvas_set_color(canvas, ColorWhite);
-                        if(whiteB) canvas_draw_line(canvas, sx + 2, sy, sx + 2, sy + 1);
-                    }
-                }
-
-                if((tiles.dr != WALL_TILE) && (tiles.r == WALL_TILE) && (tiles.d == WALL_TILE)) {
-                    canvas_set_color(canvas, ColorWhite);
-                    if(whiteB) canvas_draw_line(canvas, ex - 1, ey - 1, ex - 1, ey);
-                }
-            }
+            canvas_draw_icon(canvas, sx, sy, icon);
         }
     }
+
+    draw_wall_outline(canvas, whiteB ? &view->walls.bright : &view->walls.plain);
 }
 
 //-----------------------------------------------------------------------------
 
-void draw_movable(Canvas* canvas, Game* game, uint32_t frameNo) {
-    bool oddFrame = (frameNo % 20 < 10);
-    if(game->currentMovable != MOVABLE_NOT_FOUND) {
+void draw_movable(Canvas* canvas, RenderSnapshot* view) {
+    bool oddFrame = blink_phase(500);
+    if(view->currentMovable != MOVABLE_NOT_FOUND) {
         canvas_set_color(canvas, ColorBlack);
-        uint8_t x = coord_x(game->currentMovable);
-        uint8_t y = coord_y(game->currentMovable);
-        uint8_t how_movable = game->movables[y][x];
+        uint8_t x = coord_x(view->currentMovable);
+        uint8_t y = coord_y(view->currentMovable);
+        uint8_t how_movable = view->movables[y][x];
 
         if((how_movable & MOVABLE_LEFT) != 0) {
             canvas_draw_icon(
@@ -579,12 +523,12 @@ void draw_movable(Canvas* canvas, Game* game, uint32_t frameNo) {
 
 //-----------------------------------------------------------------------------
 
-void draw_direction(Canvas* canvas, Game* game, uint32_t frameNo) {
-    bool oddFrame = (frameNo % 20 < 10);
-    if(game->currentMovable != MOVABLE_NOT_FOUND) {
+void draw_direction(Canvas* canvas, RenderSnapshot* view) {
+    bool oddFrame = blink_phase(500);
+    if(view->currentMovable != MOVABLE_NOT_FOUND) {
         canvas_set_color(canvas, ColorBlack);
-        uint8_t x = coord_x(game->currentMovable);
-        uint8_t y = coord_y(game->currentMovable);
+        uint8_t x = coord_x(view->currentMovable);
+        uint8_t y = coord_y(view->currentMovable);
 
         if(oddFrame) {
             canvas_draw_icon(canvas, (x - 1) * TILE_SIZE, y * TILE_SIZE, &I_mov_l);
@@ -595,13 +539,13 @@ void draw_direction(Canvas* canvas, Game* game, uint32_t frameNo) {
 
 //-----------------------------------------------------------------------------
 
-void draw_direction_solution(Canvas* canvas, Game* game, uint32_t frameNo) {
-    bool oddFrame = (frameNo % 20 < 10);
-    if(game->currentMovable != MOVABLE_NOT_FOUND) {
+void draw_direction_solution(Canvas* canvas, RenderSnapshot* view) {
+    bool oddFrame = blink_phase(500);
+    if(view->currentMovable != MOVABLE_NOT_FOUND) {
         canvas_set_color(canvas, ColorBlack);
-        uint8_t x = coord_x(game->currentMovable);
-        uint8_t y = coord_y(game->currentMovable);
-        uint8_t how_movable = game->movables[y][x];
+        uint8_t x = coord_x(view->currentMovable);
+        uint8_t y = coord_y(view->currentMovable);
+        uint8_t how_movable = view->movables[y][x];
 
         if((how_movable & MOVABLE_LEFT) != 0) {
             canvas_draw_icon(
@@ -623,149 +567,141 @@ void draw_direction_solution(Canvas* canvas, Game* game, uint32_t frameNo) {
             canvas_draw_frame(canvas, x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE + 1, TILE_SIZE + 1);
         }
     }
-
-    game->move.frameNo--;
-    if(game->move.frameNo == 0) {
-        solution_move(game);
-    }
 }
 
 //-----------------------------------------------------------------------------
 
-void draw_ani_sides(Canvas* canvas, Game* game) {
-    uint8_t tile, sx, sy, deltaX;
+void draw_ani_sides(Canvas* canvas, Renderer* render, RenderSnapshot* view) {
+    uint8_t sx, sy, deltaX;
 
-    if(game->state == MOVE_SIDES) {
-        tile = game->board[game->move.y][game->move.x];
-        deltaX = ((game->move.dir & MOVABLE_LEFT) != 0) ? -1 : 1;
+    if(view->state == MOVE_SIDES) {
+        const Icon* icon = render->boardIcons.icons[view->move.y][view->move.x];
+        deltaX = ((view->move.dir & MOVABLE_LEFT) != 0) ? -1 : 1;
 
-        sx = (game->move.x * TILE_SIZE) + (deltaX * game->move.frameNo);
-        sy = game->move.y * TILE_SIZE;
+        sx = (view->move.x * TILE_SIZE) + (deltaX * view->move.frameNo);
+        sy = view->move.y * TILE_SIZE;
 
-        canvas_set_color(canvas, ColorBlack);
-        canvas_draw_icon(canvas, sx, sy, tile_to_icon(tile, game->state == GAME_OVER));
+        if(icon != NULL) {
+            canvas_set_color(canvas, ColorBlack);
+            canvas_draw_icon(canvas, sx, sy, icon);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void draw_ani_gravity(Canvas* canvas, Renderer* render, RenderSnapshot* view) {
+    uint8_t i, x, y;
+    const Icon* icon;
 
-        game->move.frameNo++;
+    if(view->state == MOVE_GRAVITY) {
+        canvas_set_color(canvas, ColorBlack);
+        for(i = 0; i < view->animatedCount; i++) {
+            x = coord_x(view->animatedCells[i]);
+            y = coord_y(view->animatedCells[i]);
+            icon = render->boardIcons.icons[y][x];
 
-        if(game->move.frameNo > TILE_SIZE) {
-            stop_move(game);
+            if(icon != NULL) {
+                canvas_draw_icon(canvas, x * TILE_SIZE, y * TILE_SIZE + view->move.frameNo, icon);
+            }
         }
     }
 }
 
 //-----------------------------------------------------------------------------
 
-void draw_ani_gravity(Canvas* canvas, Game* game) {
-    uint8_t tile, x, y, sx, sy;
+void draw_ani_explode(Canvas* canvas, Renderer* render, RenderSnapshot* view) {
+    uint8_t i, x, y, sx, sy, cx, cy, s, o;
+    const Icon* icon;
 
-    if(game->state == MOVE_GRAVITY) {
-        for(y = 0; y < SIZE_Y; y++) {
-            for(x = 0; x < SIZE_X; x++) {
-                tile = game->board[y][x];
+    if(view->state == EXPLODE) {
+        for(i = 0; i < view->animatedCount; i++) {
+            x = coord_x(view->animatedCells[i]);
+            y = coord_y(view->animatedCells[i]);
+            icon = render->boardIcons.icons[y][x];
 
+            if(icon != NULL) {
                 sx = x * TILE_SIZE;
                 sy = y * TILE_SIZE;
+                cx = sx + 4;
+                cy = sy + 4;
 
-                if((tile > 0) && (game->toAnimate[y][x] == 1)) {
+                if((view->move.delay % 4 < 2) || (view->move.delay > 8)) {
                     canvas_set_color(canvas, ColorBlack);
-                    canvas_draw_icon(
-                        canvas,
-                        sx,
-                        sy + game->move.frameNo,
-                        tile_to_icon(tile, game->state == GAME_OVER));
+                    canvas_draw_icon(canvas, sx, sy, icon);
                 }
-            }
-        }
 
-        if(game->move.delay > 0) {
-            game->move.delay--;
-            return;
-        }
-
-        game->move.frameNo++;
-        if(game->move.frameNo > TILE_SIZE) {
-            stop_gravity(game);
+                if(view->move.frameNo > 0) {
+                    canvas_set_color(canvas, ColorXOR);
+                    o = MIN(((view->move.frameNo - 1) / 2), (uint8_t)4);
+                    s = (o * 2) + 1;
+                    canvas_draw_box(canvas, cx - o, cy - o, s, s);
+                }
+            }
         }
     }
 }
 
 //-----------------------------------------------------------------------------
 
-void draw_ani_explode(Canvas* canvas, Game* game) {
-    uint8_t tile, x, y, sx, sy, cx, cy, s, o;
-
-    if(game->state == EXPLODE) {
-        for(y = 0; y < SIZE_Y; y++) {
-            for(x = 0; x < SIZE_X; x++) {
-                tile = game->board[y][x];
-
-                if((tile > 0) && (game->toAnimate[y][x] == 1)) {
-                    sx = x * TILE_SIZE;
-                    sy = y * TILE_SIZE;
-                    cx = sx + 4;
-                    cy = sy + 4;
-
-                    if((game->move.delay % 4 < 2) || (game->move.delay > 8)) {
-                        canvas_set_color(canvas, ColorBlack);
-                        canvas_draw_icon(
-                            canvas, sx, sy, tile_to_icon(tile, game->state == GAME_OVER));
-                    }
-
-                    if(game->move.frameNo > 0) {
-                        canvas_set_color(canvas, ColorXOR);
-                        o = MIN(((game->move.frameNo - 1) / 2), (uint8_t)4);
-                        s = (o * 2) + 1;
-                        canvas_draw_box(canvas, cx - o, cy - o, s, s);
-                    }
-                }
-            }
-        }
-
-        if(game->move.delay > 0) {
-            game->move.delay--;
-            return;
-        }
+void draw_flash(Canvas* canvas, RenderSnapshot* view) {
+    uint8_t i, x, y;
 
-        game->move.frameNo++;
-        if(game->move.frameNo > 10) {
-            stop_explosion(game);
-        }
+    canvas_set_color(canvas, ColorXOR);
+    for(i = 0; i < view->animatedCount; i++) {
+        x = coord_x(view->animatedCells[i]);
+        y = coord_y(view->animatedCells[i]);
+        canvas_draw_box(canvas, x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE);
     }
 }
 
 //-----------------------------------------------------------------------------
 
-void draw_scores(Canvas* canvas, Game* game, uint32_t frameNo) {
+void draw_scores(Canvas* canvas, Renderer* render, RenderSnapshot* view) {
     BoundingBox box;
     int bufSize = 80;
     char buf[bufSize];
 
-    bool showScore = (frameNo % 200) < 100;
+    bool showScore = blink_phase(5000);
 
     canvas_set_color(canvas, ColorBlack);
     canvas_draw_rbox(canvas, 82, 1, 46, 17, 2);
 
-    canvas_set_custom_u8g2_font(canvas, app_u8g2_font_squeezed_r6_tr);
     canvas_set_color(canvas, ColorWhite);
     set_bounding_box(&box, 82, 1, 46, 17);
     elements_multiline_text_aligned_limited(
         canvas,
+        &render->titleLayout,
+        view->levelTitleRev,
         &box,
         box.width / 2,
         box.height / 2,
         2,
         AlignCenter,
         AlignCenter,
-        furi_string_get_cstr(game->levelData->title));
+        app_u8g2_font_squeezed_r6_tr,
+        view->levelTitle);
 
-    if(game->solutionMode) {
+    if(view->solutionMode) {
         canvas_set_color(canvas, ColorBlack);
         canvas_set_custom_u8g2_font(canvas, app_u8g2_font_wedge_tr);
         canvas_draw_str_aligned(canvas, 104, 27, AlignCenter, AlignTop, "Solution");
         canvas_set_custom_u8g2_font(canvas, app_u8g2_font_tom_thumb_4x6_mr);
         memset(buf, 0, bufSize);
-        snprintf(buf, sizeof(buf), "%d of %d", game->solutionStep + 1, game->solutionTotal);
+        snprintf(
+            buf,
+            sizeof(buf),
+            "%d of %d",
+            MIN(view->solutionStep + 1, view->solutionTotal),
+            view->solutionTotal);
         canvas_draw_str_aligned(canvas, 104, 34, AlignCenter, AlignTop, buf);
+        memset(buf, 0, bufSize);
+        if(view->solutionPaused) {
+            snprintf(buf, sizeof(buf), "paused");
+        } else {
+            snprintf(buf, sizeof(buf), "speed %d", view->solutionSpeed + 1);
+        }
+        canvas_draw_str_aligned(canvas, 104, 41, AlignCenter, AlignTop, buf);
     } else {
         canvas_set_color(canvas, ColorBlack);
         canvas_set_custom_u8g2_font(canvas, app_u8g2_font_wedge_tr);
@@ -774,13 +710,13 @@ void draw_scores(Canvas* canvas, Game* game, uint32_t frameNo) {
         canvas_set_custom_u8g2_font(canvas, app_u8g2_font_tom_thumb_4x6_mr);
         memset(buf, 0, bufSize);
         if(showScore) {
-            if(game->score == 0) {
+            if(view->score == 0) {
                 snprintf(buf, sizeof(buf), "on par");
             } else {
-                snprintf(buf, sizeof(buf), "%+d", game->score);
+                snprintf(buf, sizeof(buf), "%+d", view->score);
             }
         } else {
-            snprintf(buf, sizeof(buf), "%u/%u", game->currentLevel + 1, game->levelSet->maxLevel);
+            snprintf(buf, sizeof(buf), "%u/%u", view->currentLevel + 1, view->maxLevel);
         }
 
         canvas_draw_str_aligned(canvas, 104, 27, AlignCenter, AlignTop, buf);
@@ -792,9 +728,9 @@ void draw_scores(Canvas* canvas, Game* game, uint32_t frameNo) {
         memset(buf, 0, bufSize);
 
         if(showScore) {
-            snprintf(buf, sizeof(buf), "%s", game->parLabel);
+            snprintf(buf, sizeof(buf), "%s", view->parLabel);
         } else {
-            snprintf(buf, sizeof(buf), "%u/%u", game->gameMoves, game->levelData->gamePar);
+            snprintf(buf, sizeof(buf), "%u/%u", view->gameMoves, view->gamePar);
         }
 
         canvas_draw_str_aligned(canvas, 104, 41, AlignCenter, AlignTop, buf);
@@ -803,63 +739,81 @@ void draw_scores(Canvas* canvas, Game* game, uint32_t frameNo) {
 
 //-----------------------------------------------------------------------------
 
-void draw_paused(Canvas* canvas, Game* game) {
+void draw_paused(Canvas* canvas, RenderSnapshot* view) {
     gray_canvas(canvas);
 
     menu_pill(
         canvas,
         0,
         MENU_PAUSED_COUNT,
-        ((game->menuPausedPos == 0) && (game->undoMovable != MOVABLE_NOT_FOUND)),
-        game->undoMovable == MOVABLE_NOT_FOUND,
+        ((view->menuPausedPos == 0) && view->canUndo),
+        !view->canUndo,
         "Undo",
         &I_ico_undo);
     menu_pill(
-        canvas, 1, MENU_PAUSED_COUNT, game->menuPausedPos == 1, false, "Restart", &I_ico_restart);
-    menu_pill(canvas, 2, MENU_PAUSED_COUNT, game->menuPausedPos == 2, false, "Menu", &I_ico_home);
-    menu_pill(canvas, 3, MENU_PAUSED_COUNT, game->menuPausedPos == 3, false, "Skip", &I_ico_skip);
-    menu_pill(canvas, 4, MENU_PAUSED_COUNT, game->menuPausedPos == 4, false, "Count", &I_ico_hist);
+        canvas,
+        1,
+        MENU_PAUSED_COUNT,
+        ((view->menuPausedPos == 1) && view->canRedo),
+        !view->canRedo,
+        "Redo",
+        &I_ico_redo);
     menu_pill(
-        canvas, 5, MENU_PAUSED_COUNT, game->menuPausedPos == 5, false, "Solve", &I_ico_check);
-
-    canvas_set_color(canvas, ColorBlack);
-    canvas_set_font(canvas, FontSecondary);
-    elements_button_right_back(canvas, "Back to game");
+        canvas, 2, MENU_PAUSED_COUNT, view->menuPausedPos == 2, false, "Restart", &I_ico_restart);
+    menu_pill(canvas, 3, MENU_PAUSED_COUNT, view->menuPausedPos == 3, false, "Menu", &I_ico_home);
+    menu_pill(canvas, 4, MENU_PAUSED_COUNT, view->menuPausedPos == 4, false, "Skip", &I_ico_skip);
+    menu_pill(canvas, 5, MENU_PAUSED_COUNT, view->menuPausedPos == 5, false, "Count", &I_ico_hist);
+    menu_pill(
+        canvas,
+        6,
+        MENU_PAUSED_COUNT,
+        ((view->menuPausedPos == 6) && view->canSolve),
+        !view->canSolve,
+        "Solve",
+        &I_ico_check);
+    menu_pill(
+        canvas,
+        7,
+        MENU_PAUSED_COUNT,
+        view->menuPausedPos == 7,
+        !view->turbo,
+        "Turbo",
+        &I_ico_turbo);
 }
 
 //-----------------------------------------------------------------------------
 
-void draw_histogram(Canvas* canvas, Stats* stats) {
+void draw_histogram(Canvas* canvas, RenderSnapshot* view) {
     gray_canvas(canvas);
-    panel_histogram(canvas, furi_string_get_cstr(stats->bricksNonZero), stats->statsNonZero);
+    panel_histogram(canvas, view->bricksNonZero, view->statsNonZero);
 }
 
-void draw_playfield_hint(Canvas* canvas, Game* game) {
-    if(game->state == SELECT_BRICK) {
-        if((game->currentMovable != MOVABLE_NOT_FOUND) &&
-           (movable_dir(&game->movables, game->currentMovable) == MOVABLE_BOTH)) {
+void draw_playfield_hint(Canvas* canvas, RenderSnapshot* view) {
+    if(view->state == SELECT_BRICK) {
+        if((view->currentMovable != MOVABLE_NOT_FOUND) &&
+           (movable_dir(&view->movables, view->currentMovable) == MOVABLE_BOTH)) {
             hint_pill_double(canvas, "Select", "Choose", &I_hint_2);
         } else {
             hint_pill_double(canvas, "Select", "Move", &I_hint_1);
         }
     }
 
-    if(game->state == SELECT_DIRECTION) {
+    if(view->state == SELECT_DIRECTION) {
         hint_pill_double(canvas, "Move", "Cancel", &I_hint_3);
     }
 
-    if(game->state == SOLUTION_SELECT || game->solutionMode) {
-        hint_pill_double(canvas, "ANY", "CANCEL", &I_hint_4);
+    if(view->state == SOLUTION_SELECT || view->solutionMode) {
+        hint_pill_double(canvas, "Seek", view->solutionPaused ? "Play" : "Pause", &I_hint_1);
     } else {
-        if(game->state == MOVE_SIDES) {
+        if(view->state == MOVE_SIDES) {
             hint_pill_single(canvas, "moving..");
         }
 
-        if(game->state == MOVE_GRAVITY) {
+        if(view->state == MOVE_GRAVITY) {
             hint_pill_single(canvas, "falling..");
         }
 
-        if(game->state == EXPLODE) {
+        if(view->state == EXPLODE) {
             hint_pill_single(canvas, "BOOM!");
         }
     }
@@ -889,11 +843,11 @@ void draw_game_over(Canvas* canvas, GameOver gameOverReason) {
 
 //-----------------------------------------------------------------------------
 
-void draw_level_finished(Canvas* canvas, Game* game) {
+void draw_level_finished(Canvas* canvas, RenderSnapshot* view) {
     int bufSize = 80;
     char buf[bufSize];
 
-    bool hasNext = game->currentLevel < game->levelSet->maxLevel - 1;
+    bool hasNext = view->currentLevel < view->maxLevel - 1;
 
     gray_canvas(canvas);
 
@@ -908,17 +862,17 @@ void draw_level_finished(Canvas* canvas, Game* game) {
     canvas_set_custom_u8g2_font(canvas, app_u8g2_font_squeezed_r7_tr);
     canvas_draw_str_aligned(canvas, x + 25, y + 4, AlignCenter, AlignTop, "Moves/Par");
     memset(buf, 0, bufSize);
-    snprintf(buf, sizeof(buf), "%u / %u", game->gameMoves, game->levelData->gamePar);
+    snprintf(buf, sizeof(buf), "%u / %u", view->gameMoves, view->gamePar);
     canvas_set_font(canvas, FontPrimary);
     canvas_draw_str_aligned(canvas, x + 25, y + 22, AlignCenter, AlignBottom, buf);
 
     canvas_set_custom_u8g2_font(canvas, app_u8g2_font_squeezed_r7_tr);
     canvas_draw_str_aligned(canvas, x + 75, y + 4, AlignCenter, AlignTop, "Score");
     memset(buf, 0, bufSize);
-    if(game->score == 0) {
+    if(view->score == 0) {
         snprintf(buf, sizeof(buf), "on par");
     } else {
-        snprintf(buf, sizeof(buf), "%+d", game->score);
+        snprintf(buf, sizeof(buf), "%+d", view->score);
     }
     canvas_set_font(canvas, FontPrimary);
     canvas_draw_str_aligned(canvas, x + 75, y + 22, AlignCenter, AlignBottom, buf);
@@ -935,11 +889,11 @@ void draw_level_finished(Canvas* canvas, Game* game) {
 
 //-----------------------------------------------------------------------------
 
-void draw_solution_prompt(Canvas* canvas, Game* game) {
+void draw_solution_prompt(Canvas* canvas, RenderSnapshot* view) {
     gray_canvas(canvas);
 
     const uint8_t y = dialog_frame(canvas, 100, 40, true, false, "Show solution?");
-    const bool penalty = solution_will_have_penalty(game);
+    const bool penalty = view->solutionPenalty;
 
     canvas_set_color(canvas, ColorBlack);
     canvas_set_custom_u8g2_font(canvas, app_u8g2_font_squeezed_r7_tr);
@@ -960,8 +914,8 @@ void draw_solution_prompt(Canvas* canvas, Game* game) {
 
 //-----------------------------------------------------------------------------
 
-void draw_reset_prompt(Canvas* canvas, Game* game) {
-    UNUSED(game);
+void draw_reset_prompt(Canvas* canvas, RenderSnapshot* view) {
+    UNUSED(view);
 
     gray_canvas(canvas);
 
@@ -986,8 +940,8 @@ void draw_reset_prompt(Canvas* canvas, Game* game) {
 
 //-----------------------------------------------------------------------------
 
-void draw_invalid_prompt(Canvas* canvas, Game* game) {
-    UNUSED(game);
+void draw_invalid_prompt(Canvas* canvas, RenderSnapshot* view) {
+    UNUSED(view);
 
     gray_canvas(canvas);
 
@@ -1004,11 +958,48 @@ void draw_invalid_prompt(Canvas* canvas, Game* game) {
         y + 10,
         AlignCenter,
         AlignTop,
-        furi_string_get_cstr(game->errorMsg));
+        view->errorMsg);
 
     canvas_draw_str_aligned(
         canvas, GUI_DISPLAY_CENTER_X, y + 21, AlignCenter, AlignTop, "Repair or remove file!");
 
     canvas_set_font(canvas, FontSecondary);
     elements_button_center(canvas, "Understood");
+}
+
+//-----------------------------------------------------------------------------
+
+void draw_profiler(Canvas* canvas, Renderer* render, RenderSnapshot* view) {
+    static const char metricLabels[ProfileMetricCount] = {'D', 'E', 'W'};
+    char buf[24];
+    uint8_t m;
+    Profiler* p = &render->drawProfile;
+
+    canvas_set_color(canvas, ColorWhite);
+    canvas_draw_box(canvas, 0, 0, 66, 38);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_draw_frame(canvas, 0, 0, 66, 38);
+    canvas_set_font(canvas, FontSecondary);
+
+    // p50 / p99 in microseconds, for the state being drawn
+    for(m = 0; m < ProfileMetricCount; m++) {
+        ProfileHistogram* h =
+            (m == ProfileDraw) ? &p->hist[view->state][m] : &view->profile[m];
+        snprintf(
+            buf,
+            sizeof(buf),
+            "%c %u/%u",
+            metricLabels[m],
+            (unsigned int)profiler_percentile(h, 50),
+            (unsigned int)profiler_percentile(h, 99));
+        canvas_draw_str(canvas, 2, 9 + m * 9, buf);
+    }
+
+    snprintf(
+        buf,
+        sizeof(buf),
+        "drop %u/%u",
+        (unsigned int)p->drops[view->state],
+        (unsigned int)p->frames[view->state]);
+    canvas_draw_str(canvas, 2, 36, buf);
 }
\ No newline at end of file
@@ -1,26 +1,31 @@
 #pragma once
 
-#include "game.h"
+#include "render.h"
 
-void draw_app(Canvas* canvas, Game* game);
-void draw_intro(Canvas* canvas, Game* game, uint32_t frameNo);
-void draw_reset_prompt(Canvas* canvas, Game* game);
-void draw_about(Canvas* canvas, Game* game, uint32_t frameNo);
-void draw_set_info(Canvas* canvas, Game* game);
-void draw_level_info(Canvas* canvas, Game* game);
-void draw_main_menu(Canvas* canvas, Game* game);
-void draw_playground(Canvas* canvas, Game* game);
-void draw_movable(Canvas* canvas, Game* game, uint32_t frameNo);
-void draw_direction(Canvas* canvas, Game* game, uint32_t frameNo);
-void draw_direction_solution(Canvas* canvas, Game* game, uint32_t frameNo);
-void draw_ani_sides(Canvas* canvas, Game* game);
-void draw_ani_gravity(Canvas* canvas, Game* game);
-void draw_ani_explode(Canvas* canvas, Game* game);
-void draw_scores(Canvas* canvas, Game* game, uint32_t frameNo);
-void draw_paused(Canvas* canvas, Game* game);
-void draw_histogram(Canvas* canvas, Stats* stats);
-void draw_playfield_hint(Canvas* canvas, Game* game);
+void draw_app(Canvas* canvas, Renderer* render, RenderSnapshot* view);
+void update_board_icons(Renderer* render, RenderSnapshot* view);
+void draw_static_layer(Canvas* canvas, Renderer* render, RenderSnapshot* view);
+void draw_intro(Canvas* canvas, RenderSnapshot* view);
+void draw_reset_prompt(Canvas* canvas, RenderSnapshot* view);
+void draw_about(Canvas* canvas, RenderSnapshot* view);
+void draw_set_info(Canvas* canvas, Renderer* render, RenderSnapshot* view);
+void draw_level_info(Canvas* canvas, RenderSnapshot* view);
+void draw_main_menu(Canvas* canvas, Renderer* render, RenderSnapshot* view);
+void draw_wall_outline(Canvas* canvas, WallOutline* outline);
+void draw_playground(Canvas* canvas, Renderer* render, RenderSnapshot* view);
+void draw_movable(Canvas* canvas, RenderSnapshot* view);
+void draw_direction(Canvas* canvas, RenderSnapshot* view);
+void draw_direction_solution(Canvas* canvas, RenderSnapshot* view);
+void draw_ani_sides(Canvas* canvas, Renderer* render, RenderSnapshot* view);
+void draw_ani_gravity(Canvas* canvas, Renderer* render, RenderSnapshot* view);
+void draw_ani_explode(Canvas* canvas, Renderer* render, RenderSnapshot* view);
+void draw_flash(Canvas* canvas, RenderSnapshot* view);
+void draw_scores(Canvas* canvas, Renderer* render, RenderSnapshot* view);
+void draw_paused(Canvas* canvas, RenderSnapshot* view);
+void draw_histogram(Canvas* canvas, RenderSnapshot* view);
+void draw_playfield_hint(Canvas* canvas, RenderSnapshot* view);
 void draw_game_over(Canvas* canvas, GameOver gameOverReason);
-void draw_level_finished(Canvas* canvas, Game* game);
-void draw_solution_prompt(Canvas* canvas, Game* game);
-void draw_invalid_prompt(Canvas* canvas, Game* game);
\ No newline at end of file
+void draw_level_finished(Canvas* canvas, RenderSnapshot* view);
+void draw_solution_prompt(Canvas* canvas, RenderSnapshot* view);
+void draw_invalid_prompt(Canvas* canvas, RenderSnapshot* view);
+void draw_profiler(Canvas* canvas, Renderer* render, RenderSnapshot* view);
\ No newline at end of file
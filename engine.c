@@ -0,0 +1,380 @@
+#include "engine.h"
+
+bool is_block(uint8_t tile) {
+    return (tile > 0) && (tile != WALL_TILE);
+}
+
+//-----------------------------------------------------------------------------
+
+// With NULL list moves are only counted
+uint8_t generate_moves(PlayGround* pg, MoveList* list) {
+    uint8_t x, y;
+    uint8_t count = 0;
+
+    for(y = 0; y < SIZE_Y; y++) {
+        const uint8_t* row = (*pg)[y];
+
+        // moves need an empty cell and a brick next to each other, so pairs
+        // of cells are checked instead of neighbourhood of every brick
+        for(x = 0; x < SIZE_X - 1; x++) {
+            if(row[x] == EMPTY_TILE) {
+                if(is_block(row[x + 1])) {
+                    if(list != NULL) {
+                        list->moves[count].coord = BOARD_COORD(x + 1, y);
+                        list->moves[count].dir = MOVABLE_LEFT;
+                    }
+                    count++;
+                }
+            } else if((row[x + 1] == EMPTY_TILE) && is_block(row[x])) {
+                if(list != NULL) {
+                    list->moves[count].coord = BOARD_COORD(x, y);
+                    list->moves[count].dir = MOVABLE_RIGHT;
+                }
+                count++;
+            }
+        }
+    }
+
+    if(list != NULL) list->count = count;
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+
+void map_moves(MoveList* list, PlayGround* mv) {
+    uint8_t i;
+
+    memset(mv, MOVABLE_NOT, sizeof(PlayGround));
+    for(i = 0; i < list->count; i++) {
+        const BoardMove* move = &list->moves[i];
+        (*mv)[BOARD_COORD_Y(move->coord)][BOARD_COORD_X(move->coord)] += move->dir;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void map_movability(PlayGround* pg, PlayGround* mv) {
+    MoveList list;
+
+    generate_moves(pg, &list);
+    map_moves(&list, mv);
+}
+
+//-----------------------------------------------------------------------------
+
+int load_level_row(uint8_t* pb, const char* psz, const char* pszMax) {
+    int cBlocks = 0;
+    for(; psz < pszMax; psz++) {
+        char ch = *psz;
+
+        // Is this a number (non-moveable blocks?)
+
+        int c = 0;
+        while(ch >= '0' && ch <= '9') {
+            c = c * 10 + ch - '0';
+            psz++;
+            if(psz >= pszMax) break;
+            ch = *psz;
+        }
+        if(c != 0) {
+            cBlocks += c;
+            if(pb != NULL) {
+                while(c != 0) {
+                    *pb++ = 9;
+                    c--;
+                }
+            }
+            psz--;
+            continue;
+        }
+
+        // Is this empty space?
+
+        if(ch == '~') {
+            cBlocks++;
+            if(pb != NULL) *pb++ = 0;
+            continue;
+        }
+
+        // This is a block type. Remember it verbatim
+
+        if(ch < 'a' || ch > 'h') return -1;
+
+        cBlocks++;
+        if(pb != NULL) *pb++ = ch - 'a' + 1;
+    }
+
+    return cBlocks;
+}
+
+//-----------------------------------------------------------------------------
+
+bool parse_level_notation(const char* pszLevel, PlayGround* level) {
+    uint8_t* pbLoad;
+
+    const char* pszLast = pszLevel;
+    bool fLoop = true;
+    int cRows = 0;
+    int cCols = -1;
+    while(fLoop) {
+        int cColsT;
+        const char* pszNext = strchr(pszLast, '/');
+        if(pszNext == NULL) {
+            pszNext = pszLast + strlen(pszLast);
+            fLoop = false;
+        }
+        cColsT = load_level_row(NULL, pszLast, pszNext);
+        if(cCols == -1) {
+            cCols = cColsT;
+        } else if(cCols != cColsT) {
+            return false;
+        }
+        cRows++;
+        pszLast = pszNext + 1;
+    }
+
+    // Vexed wants these sizes
+
+    if(cCols != SIZE_X || cRows != SIZE_Y) return false;
+
+    // Load it this time
+
+    memset(level, '\0', sizeof(uint8_t) * SIZE_X * SIZE_Y);
+
+    pbLoad = level[0][0];
+    pszLast = pszLevel;
+    fLoop = true;
+    while(fLoop) {
+        // Find the end of this row
+
+        const char* pszNext = strchr(pszLast, '/');
+        if(pszNext == NULL) {
+            pszNext = pszLast + strlen(pszLast);
+            fLoop = false;
+        }
+
+        // Load the row
+
+        load_level_row(pbLoad, pszLast, pszNext);
+
+        // Next row...
+
+        pbLoad += SIZE_X;
+        pszLast = pszNext + 1;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool mark_falling(PlayGround* pg, PlayGround* mask) {
+    uint8_t x, y;
+    bool change = false;
+
+    memset(mask, '\0', sizeof(uint8_t) * SIZE_X * SIZE_Y);
+
+    // go through it bottom to top so as all the blocks tumble down on top of each other
+    for(y = (SIZE_Y - 2); y > 0; y--) {
+        for(x = (SIZE_X - 1); x > 0; x--) {
+            if((is_block((*pg)[y][x])) && ((*pg)[y + 1][x] == EMPTY_TILE)) {
+                change = true;
+                (*mask)[y][x] = 1;
+            }
+        }
+    }
+
+    return change;
+}
+
+//-----------------------------------------------------------------------------
+
+void apply_falling(PlayGround* pg, PlayGround* mask) {
+    uint8_t x, y;
+    for(y = 0; y < SIZE_Y - 1; y++) {
+        for(x = 0; x < SIZE_X; x++) {
+            if((*mask)[y][x] == 1) {
+                (*pg)[y + 1][x] = (*pg)[y][x];
+                (*pg)[y][x] = EMPTY_TILE;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+bool mark_exploding(PlayGround* pg, PlayGround* mask) {
+    uint8_t x, y, tile;
+    bool change = false;
+
+    memset(mask, '\0', sizeof(uint8_t) * SIZE_X * SIZE_Y);
+
+    for(y = 0; y < SIZE_Y; y++) {
+        for(x = 0; x < SIZE_X; x++) {
+            tile = (*pg)[y][x];
+            if(is_block(tile)) {
+                if(((y > 0) && (tile == (*pg)[y - 1][x])) ||
+                   ((x > 0) && (tile == (*pg)[y][x - 1])) ||
+                   ((y < SIZE_Y - 1) && (tile == (*pg)[y + 1][x])) ||
+                   ((x < SIZE_X - 1) && (tile == (*pg)[y][x + 1]))) {
+                    change = true;
+                    (*mask)[y][x] = 1;
+                }
+            }
+        }
+    }
+
+    return change;
+}
+
+//-----------------------------------------------------------------------------
+
+void apply_exploding(PlayGround* pg, PlayGround* mask) {
+    uint8_t x, y;
+    for(y = 0; y < SIZE_Y - 1; y++) {
+        for(x = 0; x < SIZE_X; x++) {
+            if((*mask)[y][x] == 1) {
+                (*pg)[y][x] = EMPTY_TILE;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void apply_slide(PlayGround* pg, uint8_t x, uint8_t y, uint8_t dir) {
+    const uint8_t tx = ((dir & MOVABLE_LEFT) != 0) ? x - 1 : x + 1;
+    const uint8_t tile = (*pg)[y][x];
+
+    (*pg)[y][x] = EMPTY_TILE;
+    (*pg)[y][MIN(tx, SIZE_X - 1)] = tile;
+}
+
+//-----------------------------------------------------------------------------
+
+void settle_board(PlayGround* pg) {
+    PlayGround mask;
+
+    // same order as animated play: fall until stable, then explode, repeat
+    do {
+        while(mark_falling(pg, &mask)) {
+            apply_falling(pg, &mask);
+        }
+        if(!mark_exploding(pg, &mask)) break;
+        apply_exploding(pg, &mask);
+    } while(true);
+}
+
+//-----------------------------------------------------------------------------
+
+void apply_move(PlayGround* pg, uint8_t x, uint8_t y, uint8_t dir) {
+    apply_slide(pg, x, y, dir);
+    settle_board(pg);
+}
+
+//-----------------------------------------------------------------------------
+
+// Logs cells marked in mask as one event, unless log cannot take it whole
+static void log_cascade_event(CascadeLog* log, uint8_t kind, uint8_t rows, PlayGround* mask) {
+    uint8_t x, y, count = 0;
+
+    if(log->truncated) return;
+
+    for(y = 0; y < SIZE_Y; y++) {
+        for(x = 0; x < SIZE_X; x++) {
+            count += (*mask)[y][x];
+        }
+    }
+    if((log->eventCount == CASCADE_EVENTS_MAX) || (log->cellCount + count > CASCADE_CELLS_MAX)) {
+        log->truncated = true;
+        return;
+    }
+
+    CascadeEvent* event = &log->events[log->eventCount++];
+    event->kind = kind;
+    event->chain = log->chains;
+    event->rows = rows;
+    event->dir = MOVABLE_NOT;
+    event->count = count;
+    event->first = log->cellCount;
+
+    for(y = 0; y < SIZE_Y; y++) {
+        for(x = 0; x < SIZE_X; x++) {
+            if((*mask)[y][x] == 1) log->cells[log->cellCount++] = BOARD_COORD(x, y);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+// Same as apply_move, logging every step of the cascade
+void resolve_move(PlayGround* pg, uint8_t x, uint8_t y, uint8_t dir, CascadeLog* log) {
+    PlayGround mask;
+    uint8_t rows;
+
+    log->eventCount = 0;
+    log->cellCount = 0;
+    log->chains = 0;
+    log->truncated = false;
+
+    memset(mask, 0, sizeof(PlayGround));
+    mask[y][x] = 1;
+    log_cascade_event(log, CascadeSlide, 0, &mask);
+    log->events[0].dir = dir;
+    apply_slide(pg, x, y, dir);
+
+    do {
+        rows = 0;
+        while(mark_falling(pg, &mask)) {
+            log_cascade_event(log, CascadeFall, ++rows, &mask);
+            apply_falling(pg, &mask);
+        }
+        if(!mark_exploding(pg, &mask)) break;
+        log->chains++;
+        log_cascade_event(log, CascadeExplode, 0, &mask);
+        apply_exploding(pg, &mask);
+    } while(true);
+}
+
+//-----------------------------------------------------------------------------
+
+void apply_cascade_event(PlayGround* pg, CascadeLog* log, uint8_t index) {
+    const CascadeEvent* event = &log->events[index];
+    uint8_t i, x, y;
+
+    for(i = 0; i < event->count; i++) {
+        x = BOARD_COORD_X(log->cells[event->first + i]);
+        y = BOARD_COORD_Y(log->cells[event->first + i]);
+
+        switch(event->kind) {
+        case CascadeSlide:
+            apply_slide(pg, x, y, event->dir);
+            break;
+        case CascadeFall:
+            (*pg)[y + 1][x] = (*pg)[y][x];
+            (*pg)[y][x] = EMPTY_TILE;
+            break;
+        case CascadeExplode:
+            (*pg)[y][x] = EMPTY_TILE;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void count_bricks(PlayGround* pg, uint8_t* ofBrick) {
+    uint8_t x, y, tile;
+
+    memset(ofBrick, '\0', sizeof(uint8_t) * WALL_TILE);
+    for(y = 0; y < SIZE_Y; y++) {
+        for(x = 0; x < SIZE_X; x++) {
+            tile = (*pg)[y][x];
+            if(is_block(tile)) {
+                ofBrick[tile]++;
+            }
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "common.h"
+
+// Board rules shared by the game and the host-side tools (see tools/).
+// Keep this module free of GUI, storage and other firmware services.
+
+#define BOARD_COORD(x, y) ((uint8_t)((y) * SIZE_X + (x))) // same as coord_from
+#define BOARD_COORD_X(coord) ((coord) % SIZE_X)
+#define BOARD_COORD_Y(coord) ((coord) / SIZE_X)
+
+// every move is a brick and an empty cell next to it in the same row
+#define BOARD_MOVES_MAX (SIZE_Y * (SIZE_X - 1))
+
+typedef struct {
+    uint8_t coord; // see BOARD_COORD
+    uint8_t dir; // MOVABLE_LEFT or MOVABLE_RIGHT
+} BoardMove;
+
+// Legal moves of a board, row by row from the top, left to right, and left
+// before right for the same brick - so the same board always lists the same
+// moves in the same order
+typedef struct {
+    BoardMove moves[BOARD_MOVES_MAX];
+    uint8_t count;
+} MoveList;
+
+#define CASCADE_EVENTS_MAX 48
+#define CASCADE_CELLS_MAX 256
+
+typedef enum {
+    CascadeSlide,
+    CascadeFall, // every brick listed falls by one row
+    CascadeExplode,
+} CascadeKind;
+
+typedef struct {
+    uint8_t kind; // CascadeKind
+    uint8_t chain; // explosions in the move so far, this one included
+    uint8_t rows; // rows fallen since last explosion, this step included
+    uint8_t dir; // of slide
+    uint8_t count;
+    uint16_t first; // cells of event, as they were before it
+} CascadeEvent;
+
+// Everything a move does to the board, step by step as it is animated:
+// the slide, then bricks falling one row at a time and exploding, until
+// the board settles. Cascades too long for the log are cut short - events
+// logged are still exact, and the board given is settled all the same.
+typedef struct {
+    CascadeEvent events[CASCADE_EVENTS_MAX];
+    uint8_t cells[CASCADE_CELLS_MAX]; // see BOARD_COORD
+    uint8_t eventCount;
+    uint16_t cellCount;
+    uint8_t chains;
+    bool truncated;
+} CascadeLog;
+
+//-----------------------------------------------------------------------------
+
+bool is_block(uint8_t tile);
+uint8_t generate_moves(PlayGround* pg, MoveList* list);
+void map_moves(MoveList* list, PlayGround* mv);
+void map_movability(PlayGround* pg, PlayGround* mv);
+
+//-----------------------------------------------------------------------------
+
+int load_level_row(uint8_t* pb, const char* psz, const char* pszMax);
+bool parse_level_notation(const char* pszLevel, PlayGround* level);
+
+//-----------------------------------------------------------------------------
+
+bool mark_falling(PlayGround* pg, PlayGround* mask);
+void apply_falling(PlayGround* pg, PlayGround* mask);
+bool mark_exploding(PlayGround* pg, PlayGround* mask);
+void apply_exploding(PlayGround* pg, PlayGround* mask);
+void apply_slide(PlayGround* pg, uint8_t x, uint8_t y, uint8_t dir);
+
+void settle_board(PlayGround* pg);
+void apply_move(PlayGround* pg, uint8_t x, uint8_t y, uint8_t dir);
+void resolve_move(PlayGround* pg, uint8_t x, uint8_t y, uint8_t dir, CascadeLog* log);
+void apply_cascade_event(PlayGround* pg, CascadeLog* log, uint8_t index);
+void count_bricks(PlayGround* pg, uint8_t* ofBrick);
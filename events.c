@@ -2,10 +2,32 @@
 
 #include "move.h"
 #include "game.h"
+#include "utils.h"
 
 //-----------------------------------------------------------------------------
 
 void events_for_selection(InputEvent* event, Game* game) {
+    if((event->key == InputKeyOk) && !game->solutionMode) {
+        // Ok acts on release, so it can be held for undo instead; press
+        // must be seen here too, one that closed a menu does not count
+        switch(event->type) {
+        case InputTypePress:
+            game->okArmed = true;
+            break;
+        case InputTypeShort:
+            if(game->okArmed) click_selected(game);
+            game->okArmed = false;
+            break;
+        case InputTypeLong:
+            if(game->okArmed) undo(game);
+            game->okArmed = false;
+            break;
+        default:
+            break;
+        }
+        return;
+    }
+
     if((event->type == InputTypePress) || (event->type == InputTypeRepeat)) {
         if(game->solutionMode) {
             end_solution(game);
@@ -13,23 +35,27 @@ void events_for_selection(InputEvent* event, Game* game) {
         }
         switch(event->key) {
         case InputKeyLeft:
-            find_movable_left(&game->movables, &game->currentMovable);
+            navigate(&game->navigation, NavLeft, &game->currentMovable);
             break;
         case InputKeyRight:
-            find_movable_right(&game->movables, &game->currentMovable);
+            navigate(&game->navigation, NavRight, &game->currentMovable);
             break;
         case InputKeyUp:
-            find_movable_up(&game->movables, &game->currentMovable);
+            navigate(&game->navigation, NavUp, &game->currentMovable);
             break;
         case InputKeyDown:
-            find_movable_down(&game->movables, &game->currentMovable);
-            break;
-        case InputKeyOk:
-            click_selected(game);
+            navigate(&game->navigation, NavDown, &game->currentMovable);
             break;
         case InputKeyBack:
-            game->menuPausedPos = (game->undoMovable == MOVABLE_NOT_FOUND) ? 4 : 0;
+            if(history_can_undo(&game->history)) {
+                game->menuPausedPos = 0;
+            } else if(history_can_redo(&game->history)) {
+                game->menuPausedPos = 1;
+            } else {
+                game->menuPausedPos = 5;
+            }
             game->state = PAUSED;
+            suspend_game(game);
             break;
         default:
             break;
@@ -62,65 +88,79 @@ void events_for_direction(InputEvent* event, Game* game) {
 
 //-----------------------------------------------------------------------------
 
+static bool paused_item_enabled(Game* game, uint8_t pos) {
+    switch(pos) {
+    case 0:
+        return history_can_undo(&game->history);
+    case 1:
+        return history_can_redo(&game->history);
+    case 6:
+        return game->levelData->solutionSteps.valid;
+    default:
+        return true;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+static void paused_move(Game* game, uint8_t step) {
+    // masked items are passed over, most items never are so this ends
+    do {
+        game->menuPausedPos = (game->menuPausedPos + step) % MENU_PAUSED_COUNT;
+    } while(!paused_item_enabled(game, game->menuPausedPos));
+}
+
+//-----------------------------------------------------------------------------
+
 void events_for_paused(InputEvent* event, Game* game) {
     if((event->type == InputTypePress) || (event->type == InputTypeRepeat)) {
         switch(event->key) {
         case InputKeyLeft:
-            game->menuPausedPos =
-                (game->menuPausedPos + MENU_PAUSED_COUNT - 1) % MENU_PAUSED_COUNT;
-            if((game->menuPausedPos == 0) && (game->undoMovable == MOVABLE_NOT_FOUND)) {
-                game->menuPausedPos =
-                    (game->menuPausedPos + MENU_PAUSED_COUNT - 1) % MENU_PAUSED_COUNT;
-            }
+            paused_move(game, MENU_PAUSED_COUNT - 1);
             break;
         case InputKeyRight:
-            game->menuPausedPos = (game->menuPausedPos + 1) % MENU_PAUSED_COUNT;
-            if((game->menuPausedPos == 0) && (game->undoMovable == MOVABLE_NOT_FOUND)) {
-                game->menuPausedPos = (game->menuPausedPos + 1) % MENU_PAUSED_COUNT;
-            }
+            paused_move(game, 1);
             break;
-
         case InputKeyUp:
-            game->menuPausedPos =
-                (game->menuPausedPos + MENU_PAUSED_COUNT - 2) % MENU_PAUSED_COUNT;
-            if((game->menuPausedPos == 0) && (game->undoMovable == MOVABLE_NOT_FOUND)) {
-                game->menuPausedPos =
-                    (game->menuPausedPos + MENU_PAUSED_COUNT - 2) % MENU_PAUSED_COUNT;
-            }
+            paused_move(game, MENU_PAUSED_COUNT - 2);
             break;
-
         case InputKeyDown:
-            game->menuPausedPos = (game->menuPausedPos + 2) % MENU_PAUSED_COUNT;
-            if((game->menuPausedPos == 0) && (game->undoMovable == MOVABLE_NOT_FOUND)) {
-                game->menuPausedPos = (game->menuPausedPos + 2) % MENU_PAUSED_COUNT;
-            }
+            paused_move(game, 2);
             break;
         case InputKeyOk:
             switch(game->menuPausedPos) {
             case 0: // undo
                 undo(game);
                 break;
-            case 1: // restart
+            case 1: // redo
+                redo(game);
+                break;
+            case 2: // restart
                 refresh_level(game);
                 break;
-            case 2: // menu
+            case 3: // menu
+                end_attempt(game);
                 game->mainMenuMode = CUSTOM;
                 game->mainMenuBtn = MODE_BTN;
                 game->state = MAIN_MENU;
                 break;
-            case 3: // skip
+            case 4: // skip
                 start_game_at_level(game, game->currentLevel + 1);
                 break;
-            case 4: // count
+            case 5: // count
                 game->state = HISTOGRAM;
                 break;
-            case 5: // solve
+            case 6: // solve
                 if(solution_will_have_penalty(game)) {
                     game->state = SOLUTION_PROMPT;
                 } else {
                     start_solution(game);
                 }
                 break;
+            case 7: // turbo
+                game->settings.turbo = !game->settings.turbo;
+                save_settings(&game->settings);
+                break;
             default:
                 break;
             }
@@ -143,6 +183,7 @@ void events_for_game_over(InputEvent* event, Game* game) {
             undo(game);
             break;
         case InputKeyOk:
+            end_attempt(game);
             game->mainMenuMode = (game->hasContinue) ? CONTINUE : NEW_GAME;
             game->mainMenuBtn = MODE_BTN;
             game->state = MAIN_MENU;
@@ -378,14 +419,32 @@ void events_for_solution_prompt(InputEvent* event, Game* game) {
 //-----------------------------------------------------------------------------
 
 void events_for_solution_select(InputEvent* event, Game* game) {
+    // while a move animates, solutionStep is the move being played
+    const bool moving = (game->state != SOLUTION_SELECT);
+
     if((event->type == InputTypePress) || (event->type == InputTypeRepeat)) {
         switch(event->key) {
         case InputKeyUp:
+            if(game->solutionSpeed < SOLUTION_SPEEDS - 1) game->solutionSpeed++;
+            break;
         case InputKeyDown:
+            if(game->solutionSpeed > 0) game->solutionSpeed--;
             break;
-        case InputKeyOk:
         case InputKeyLeft:
+            if(moving || (game->solutionStep > 0)) {
+                solution_seek(game, moving ? game->solutionStep : game->solutionStep - 1);
+            }
+            break;
         case InputKeyRight:
+            solution_seek(game, game->solutionStep + 1);
+            break;
+        case InputKeyOk:
+            if(game->solutionStep >= game->solutionTotal) {
+                end_solution(game);
+            } else {
+                game->solutionPaused = !game->solutionPaused;
+            }
+            break;
         case InputKeyBack:
             end_solution(game);
         default:
@@ -434,6 +493,120 @@ void events_for_invalid(InputEvent* event, Game* game) {
 
 //-----------------------------------------------------------------------------
 
+static bool key_to_nav(InputKey key, NavDirection* dir) {
+    switch(key) {
+    case InputKeyLeft:
+        *dir = NavLeft;
+        return true;
+    case InputKeyRight:
+        *dir = NavRight;
+        return true;
+    case InputKeyUp:
+        *dir = NavUp;
+        return true;
+    case InputKeyDown:
+        *dir = NavDown;
+        return true;
+    default:
+        return false;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void queue_input_ahead(InputEvent* event, Game* game) {
+    InputAhead* last = &game->inputAhead[MAX(game->inputAheadCount, 1) - 1];
+
+    // short is kept as well, Ok on the board acts on it
+    if((event->type != InputTypePress) && (event->type != InputTypeRepeat) &&
+       (event->type != InputTypeShort)) {
+        return;
+    }
+
+    // held key adds steps to its entry instead of filling the buffer
+    if((event->type == InputTypeRepeat) && (game->inputAheadCount > 0) &&
+       (last->event.key == event->key) &&
+       ((last->event.type == InputTypePress) || (last->event.type == InputTypeRepeat))) {
+        if(last->count < UINT8_MAX) last->count++;
+        return;
+    }
+
+    if(game->inputAheadCount >= INPUT_AHEAD_SIZE) {
+        FURI_LOG_W(TAG, "Input ahead full, key dropped");
+        return;
+    }
+    game->inputAhead[game->inputAheadCount].event = *event;
+    game->inputAhead[game->inputAheadCount].count = 1;
+    game->inputAheadCount++;
+}
+
+//-----------------------------------------------------------------------------
+
+// Forgets press and repeats of a key still held, earlier taps of it stay
+void drop_input_ahead(Game* game, InputKey key) {
+    uint8_t i, kept, from = game->inputAheadCount;
+
+    for(i = 0; i < game->inputAheadCount; i++) {
+        if((game->inputAhead[i].event.key == key) &&
+           (game->inputAhead[i].event.type == InputTypePress)) {
+            from = i;
+        }
+    }
+    for(i = kept = from; i < game->inputAheadCount; i++) {
+        if(game->inputAhead[i].event.key != key) {
+            game->inputAhead[kept++] = game->inputAhead[i];
+        }
+    }
+    game->inputAheadCount = kept;
+}
+
+//-----------------------------------------------------------------------------
+
+void replay_input_ahead(Game* game) {
+    InputAhead* ahead = &game->inputAhead[0];
+    InputEvent event;
+    NavDirection dir;
+    uint8_t i, steps;
+    bool navigation;
+
+    // each replayed key may start another move, rest waits for it to end
+    while((game->inputAheadCount > 0) && !is_state_animating(game->state)) {
+        if((game->state != SELECT_BRICK) && (game->state != SELECT_DIRECTION)) {
+            // level ended or solution runs - keys were meant for the board
+            game->inputAheadCount = 0;
+            break;
+        }
+
+        // all steps of a held arrow move selection in one go, other keys
+        // may start a move and are played one step at a time
+        event = ahead->event;
+        navigation = (game->state == SELECT_BRICK) && !game->solutionMode &&
+                     key_to_nav(event.key, &dir);
+        steps = navigation ? ahead->count : 1;
+
+        ahead->count -= steps;
+        if(ahead->count == 0) {
+            game->inputAheadCount--;
+            memmove(
+                &game->inputAhead[0],
+                &game->inputAhead[1],
+                sizeof(InputAhead) * game->inputAheadCount);
+        } else {
+            ahead->event.type = InputTypeRepeat;
+        }
+
+        if(navigation) {
+            for(i = 0; i < steps; i++) {
+                navigate(&game->navigation, dir, &game->currentMovable);
+            }
+        } else {
+            events_for_game(&event, game);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
 void events_for_game(InputEvent* event, Game* game) {
     switch(game->state) {
     case MAIN_MENU:
@@ -480,6 +653,13 @@ void events_for_game(InputEvent* event, Game* game) {
     case EXPLODE:
         if(game->solutionMode) {
             events_for_solution_select(event, game);
+        } else if(event->type == InputTypeLong) {
+            // key held since starting the move - skip the rest of it; its
+            // press and repeats were meant as the hold, not as more moves
+            drop_input_ahead(game, event->key);
+            settle_instantly(game);
+        } else {
+            queue_input_ahead(event, game);
         }
     default:
         break;
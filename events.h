@@ -2,4 +2,18 @@
 
 #include "game.h"
 
+typedef enum {
+    EventTypeTick,
+    EventTypeKey,
+} EventType;
+
+typedef struct {
+    EventType type;
+    InputEvent input;
+} GameEvent;
+
+#define EVENT_QUEUE_SIZE 16
+
 void events_for_game(InputEvent* event, Game* game);
+void replay_input_ahead(Game* game);
+void drop_input_ahead(Game* game, InputKey key);
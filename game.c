@@ -6,17 +6,14 @@ Game* alloc_game_state(int* error) {
     *error = 0;
     Game* game = malloc(sizeof(Game));
 
-    game->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
-    if(!game->mutex) {
-        FURI_LOG_E(TAG, "cannot create mutex\r\n");
-        free(game);
-        *error = 255;
-        return NULL;
-    }
-
     game->levelData = alloc_level_data();
     game->levelSet = alloc_level_set();
     game->stats = alloc_stats();
+    init_wall_geometry(&game->walls);
+    game->layerRev = 0;
+    game->levelRev = 0;
+    profiler_init(&game->profiler);
+    game->recorder = alloc_recorder();
 
     game->currentLevel = 0;
     game->gameMoves = 0;
@@ -26,8 +23,11 @@ Game* alloc_game_state(int* error) {
     game->solutionMode = false;
     game->solutionStep = 0;
     game->solutionTotal = 0;
+    game->solutionPaused = false;
+    game->solutionSpeed = SOLUTION_SPEED_NORMAL;
 
-    game->undoMovable = MOVABLE_NOT_FOUND;
+    init_history(&game->history);
+    game->okArmed = false;
     game->currentMovable = MOVABLE_NOT_FOUND;
     game->nextMovable = MOVABLE_NOT_FOUND;
     game->menuPausedPos = 0;
@@ -47,6 +47,14 @@ Game* alloc_game_state(int* error) {
     game->gameOverReason = NOT_GAME_OVER;
 
     game->move.frameNo = 0;
+    game->simTick = 0;
+    game->simStep = 0;
+    game->bgShiftX = 0;
+    game->bgShiftY = 0;
+    game->flashSteps = 0;
+    game->inputAheadCount = 0;
+    game->suspendedHash = 0;
+    game->settings.turbo = false;
 
     memset(game->parLabel, 0, PAR_LABEL_SIZE);
     game->errorMsg = furi_string_alloc();
@@ -57,11 +65,33 @@ Game* alloc_game_state(int* error) {
 //-----------------------------------------------------------------------------
 
 void load_game_board(Game* g) {
+    LevelData* ld = g->levelData;
     bool levelLoadable = false;
+
+    // restarting level, board parsed last time is still good
+    if(ld->parsed && (ld->level == g->currentLevel) &&
+       (furi_string_cmp(ld->setId, g->levelSet->id) == 0)) {
+        copy_level(g->board, ld->initialBoard);
+        return;
+    }
+
+    ld->parsed = false;
+    ld->solutionDecoded = false;
+    free_solution_track(&ld->solutionTrack);
+
     // Open storage
     Storage* storage = furi_record_open(RECORD_STORAGE);
-    if(load_level(storage, g->levelSet->id, g->currentLevel, g->levelData, g->errorMsg)) {
-        levelLoadable = parse_level_notation(furi_string_get_cstr(g->levelData->board), &g->board);
+    if(load_level(storage, g->levelSet->id, g->currentLevel, ld, g->errorMsg)) {
+        levelLoadable = parse_level_notation(furi_string_get_cstr(ld->board), &ld->initialBoard);
+    }
+    if(levelLoadable) {
+        furi_string_set(ld->setId, g->levelSet->id);
+        ld->level = g->currentLevel;
+        ld->parsed = true;
+        decode_solution(furi_string_get_cstr(ld->solution), &ld->initialBoard, &ld->solutionSteps);
+        copy_level(g->board, ld->initialBoard);
+        build_wall_geometry(&g->walls, &ld->initialBoard);
+        g->levelRev++;
     }
     // Close storage
 
@@ -76,10 +106,11 @@ void load_game_board(Game* g) {
 
 void free_game_state(Game* game) {
     view_port_free(game->viewPort);
-    furi_mutex_free(game->mutex);
     free_level_data(game->levelData);
     free_level_set(game->levelSet);
     free_stats(game->stats);
+    free_wall_geometry(&game->walls);
+    free_recorder(game->recorder);
     furi_string_free(game->selectedSet);
     furi_string_free(game->continueSet);
     furi_string_free(game->errorMsg);
@@ -89,19 +120,12 @@ void free_game_state(Game* game) {
 
 //-----------------------------------------------------------------------------
 
-GameOver is_game_over(PlayGround* mv, Stats* stats) {
-    uint8_t sumMov = 0;
+GameOver is_game_over(MoveList* moves, Stats* stats) {
     uint8_t sum = 0;
-    uint8_t x, y;
     for(uint8_t i = 0; i < WALL_TILE; i++) {
         sum += stats->ofBrick[i];
     }
-    for(y = 0; y < SIZE_Y; y++) {
-        for(x = 0; x < SIZE_X; x++) {
-            sumMov += (*mv)[y][x];
-        }
-    }
-    if((sum > 0) && (sumMov == 0)) {
+    if((sum > 0) && (moves->count == 0)) {
         return CANNOT_MOVE;
     }
     for(uint8_t i = 0; i < WALL_TILE; i++) {
@@ -217,12 +241,138 @@ void initial_load_game(Game* game) {
     furi_record_close(RECORD_STORAGE);
     index_set(game);
     recalc_score(game);
+    load_settings(&game->settings);
 
     if(game->selectedLevel > game->levelSet->maxLevel - 1) {
         game->selectedLevel = game->levelSet->maxLevel - 1;
     }
 
     randomize_bg(&game->bg);
+
+    resume_game(game);
+}
+
+//-----------------------------------------------------------------------------
+
+static uint32_t suspended_hash(SuspendedGame* suspended) {
+    const uint8_t* bytes = (const uint8_t*)suspended;
+    uint32_t hash = 2166136261u;
+    size_t i;
+
+    for(i = 0; i < sizeof(SuspendedGame); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+
+void suspend_game(Game* g) {
+    uint32_t hash;
+
+    if((g->state < SELECT_BRICK) || (g->state == LEVEL_FINISHED)) {
+        forget_suspended();
+        g->suspendedHash = 0;
+        return;
+    }
+
+    // too big for app stack
+    SuspendedGame* suspended = malloc(sizeof(SuspendedGame));
+    memset(suspended, 0, sizeof(SuspendedGame));
+
+    snprintf(suspended->setId, SUSPEND_SET_ID_SIZE, "%s", furi_string_get_cstr(g->levelSet->id));
+    suspended->level = g->currentLevel;
+    memcpy(&suspended->history, &g->history, sizeof(History));
+
+    if(g->solutionMode) {
+        // player's own board waits aside while solution is shown
+        copy_level(suspended->board, g->boardBackup);
+        suspended->currentMovable = g->currentMovableBackup;
+        suspended->gameMoves = g->gameMoves;
+    } else if(is_state_animating(g->state)) {
+        // move not recorded yet, so it is taken back
+        copy_level(suspended->board, g->boardBeforeMove);
+        suspended->currentMovable = coord_from(g->move.x, g->move.y);
+        suspended->gameMoves = g->gameMoves - 1;
+    } else {
+        copy_level(suspended->board, g->board);
+        suspended->currentMovable = g->currentMovable;
+        suspended->gameMoves = g->gameMoves;
+    }
+
+    // pausing again without a move in between does not write SD again
+    hash = suspended_hash(suspended);
+    if(hash != g->suspendedHash) {
+        g->suspendedHash = save_suspended(suspended) ? hash : 0;
+    }
+    free(suspended);
+}
+
+//-----------------------------------------------------------------------------
+
+void resume_game(Game* g) {
+    uint8_t x, y;
+    bool valid;
+
+    // set that failed to load is reported first, record waits for next launch
+    if(g->state == INVALID_PROMPT) return;
+
+    SuspendedGame* suspended = malloc(sizeof(SuspendedGame));
+
+    if(!load_suspended(suspended)) {
+        free(suspended);
+        return;
+    }
+
+    valid = history_valid(&suspended->history);
+    for(y = 0; y < SIZE_Y; y++) {
+        for(x = 0; x < SIZE_X; x++) {
+            if(suspended->board[y][x] > WALL_TILE) valid = false;
+        }
+    }
+    suspended->setId[SUSPEND_SET_ID_SIZE - 1] = 0;
+
+    // set is checked quietly - one gone missing since is not marked invalid,
+    // the record is just dropped and main menu stays as it was set up
+    if(valid && (furi_string_cmp_str(g->levelSet->id, suspended->setId) != 0)) {
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        FuriString* setId = furi_string_alloc_set(suspended->setId);
+        FuriString* errorMsg = furi_string_alloc();
+
+        valid = load_level_set(storage, setId, g->levelSet, errorMsg);
+        if(!valid) {
+            load_level_set(storage, g->selectedSet, g->levelSet, errorMsg);
+        }
+
+        furi_string_free(errorMsg);
+        furi_string_free(setId);
+        furi_record_close(RECORD_STORAGE);
+        index_set(g);
+        recalc_score(g);
+    }
+    valid = valid && (suspended->level < g->levelSet->maxLevel);
+
+    if(valid) {
+        start_game_at_level(g, suspended->level);
+        valid = (g->state == SELECT_BRICK);
+    }
+
+    if(valid) {
+        g->layerRev++;
+        copy_level(g->board, suspended->board);
+        memcpy(&g->history, &suspended->history, sizeof(History));
+        g->gameMoves = suspended->gameMoves;
+        g->currentMovable = suspended->currentMovable;
+        update_movables(g);
+        update_board_stats(&g->board, g->stats);
+        check_board_result(g);
+    } else {
+        FURI_LOG_W(TAG, "Suspended game dropped");
+        forget_suspended();
+        g->suspendedHash = 0;
+    }
+
+    free(suspended);
 }
 
 //-----------------------------------------------------------------------------
@@ -284,6 +434,7 @@ void start_game_at_level(Game* game, uint8_t levelNo) {
         game->currentLevel = levelNo;
         refresh_level(game);
     } else {
+        end_attempt(game);
         game->mainMenuBtn = LEVELSET_BTN;
         game->mainMenuMode = CUSTOM;
 
@@ -314,9 +465,11 @@ void score_for_level(Game* g, uint8_t levelNo, char* buf, size_t max) {
 //-----------------------------------------------------------------------------
 
 void refresh_level(Game* g) {
+    end_attempt(g);
+    g->layerRev++;
     clear_board(&g->board);
-    clear_board(&g->boardUndo);
-    clear_board(&g->toAnimate);
+    clear_board(&g->boardBeforeMove);
+    clear_animated(g);
 
     furi_string_set(g->selectedSet, g->levelSet->id);
     furi_string_set(g->continueSet, g->levelSet->id);
@@ -324,12 +477,13 @@ void refresh_level(Game* g) {
     g->selectedLevel = g->currentLevel;
     load_game_board(g);
 
-    map_movability(&g->board, &g->movables);
+    update_movables(g);
     update_board_stats(&g->board, g->stats);
-    g->currentMovable = find_movable(&g->movables);
-    g->undoMovable = MOVABLE_NOT_FOUND;
+    g->currentMovable = (g->moves.count > 0) ? g->moves.moves[0].coord : MOVABLE_NOT_FOUND;
+    init_history(&g->history);
     g->gameMoves = 0;
     g->state = SELECT_BRICK;
+    recorder_begin(g->recorder, furi_string_get_cstr(g->levelSet->id), g->currentLevel);
 
     memset(g->parLabel, 0, PAR_LABEL_SIZE);
     score_for_level(g, g->selectedLevel, g->parLabel, PAR_LABEL_SIZE);
@@ -352,6 +506,21 @@ void level_finished(Game* g) {
     save_last_level(g->levelSet->id, g->currentLevel);
     save_set_scores(g->levelSet->id, g->levelSet->scores);
     recalc_score(g);
+    end_attempt(g);
+}
+
+//-----------------------------------------------------------------------------
+
+void end_attempt(Game* g) {
+    TelemetryOutcome outcome = TelemetryAbandoned;
+
+    if(g->state == LEVEL_FINISHED) {
+        outcome = TelemetryFinished;
+    } else if(g->state == GAME_OVER) {
+        outcome = (TelemetryOutcome)g->gameOverReason;
+    }
+
+    recorder_end(g->recorder, (uint16_t)g->gameMoves, outcome);
 }
 
 //-----------------------------------------------------------------------------
@@ -385,125 +554,123 @@ void click_selected(Game* game) {
 
 //-----------------------------------------------------------------------------
 
-void start_gravity(Game* g) {
-    uint8_t x, y;
-    bool change = false;
-
+void clear_animated(Game* g) {
     clear_board(&g->toAnimate);
-
-    // go through it bottom to top so as all the blocks tumble down on top of each other
-    for(y = (SIZE_Y - 2); y > 0; y--) {
-        for(x = (SIZE_X - 1); x > 0; x--) {
-            if((is_block(g->board[y][x])) && (g->board[y + 1][x] == EMPTY_TILE)) {
-                change = true;
-                g->toAnimate[y][x] = 1;
-            }
-        }
-    }
-
-    if(change) {
-        g->move.frameNo = 0;
-        g->move.delay = 5;
-        g->state = MOVE_GRAVITY;
-    } else {
-        g->state = SELECT_BRICK;
-        start_explosion(g);
-    }
+    g->animatedCount = 0;
 }
 
 //-----------------------------------------------------------------------------
 
-void stop_gravity(Game* g) {
-    uint8_t x, y;
-    for(y = 0; y < SIZE_Y - 1; y++) {
-        for(x = 0; x < SIZE_X; x++) {
-            if(g->toAnimate[y][x] == 1) {
-                g->board[y + 1][x] = g->board[y][x];
-                g->board[y][x] = EMPTY_TILE;
-            }
-        }
-    }
+static void add_animated(Game* g, uint8_t eventNo) {
+    const CascadeEvent* event = &g->cascade.events[eventNo];
+    uint8_t i, cell;
 
-    start_gravity(g);
+    for(i = 0; i < event->count; i++) {
+        cell = g->cascade.cells[event->first + i];
+        if(g->toAnimate[coord_y(cell)][coord_x(cell)] == 1) continue;
+        g->toAnimate[coord_y(cell)][coord_x(cell)] = 1;
+        g->animatedCells[g->animatedCount++] = cell;
+    }
 }
 
 //-----------------------------------------------------------------------------
 
-void start_explosion(Game* g) {
-    uint8_t x, y;
-    bool change = false;
+void start_cascade_event(Game* g) {
+    g->layerRev++;
+    clear_animated(g);
 
-    clear_board(&g->toAnimate);
-
-    // go through it bottom to top so as all the blocks tumble down on top of each other
-    for(y = 0; y < SIZE_Y; y++) {
-        for(x = 0; x < SIZE_X; x++) {
-            if(is_block(g->board[y][x])) {
-                if(((y > 0) && (g->board[y][x] == g->board[y - 1][x])) ||
-                   ((x > 0) && (g->board[y][x] == g->board[y][x - 1])) ||
-                   ((y < SIZE_Y - 1) && (g->board[y][x] == g->board[y + 1][x])) ||
-                   ((x < SIZE_X - 1) && (g->board[y][x] == g->board[y][x + 1]))) {
-                    change = true;
-                    g->toAnimate[y][x] = 1;
-                }
-            }
+    if(g->cascadeEvent >= g->cascade.eventCount) {
+        // cascade cut short by the log ends at once
+        if(g->cascade.truncated) {
+            copy_level(g->board, g->boardAfterMove);
         }
+        g->state = SELECT_BRICK;
+        movement_stoped(g);
+        return;
     }
 
-    if(change) {
-        g->move.frameNo = 0;
+    add_animated(g, g->cascadeEvent);
+    g->move.frameNo = 0;
+
+    switch(g->cascade.events[g->cascadeEvent].kind) {
+    case CascadeSlide:
+        g->state = MOVE_SIDES;
+        break;
+    case CascadeFall:
+        g->move.delay = 5;
+        g->state = MOVE_GRAVITY;
+        break;
+    default:
         g->move.delay = 12;
         g->state = EXPLODE;
-    } else {
-        g->state = SELECT_BRICK;
-        movement_stoped(g);
+        break;
     }
 }
 
 //-----------------------------------------------------------------------------
 
-void stop_explosion(Game* g) {
-    uint8_t x, y;
-    for(y = 0; y < SIZE_Y - 1; y++) {
-        for(x = 0; x < SIZE_X; x++) {
-            if(g->toAnimate[y][x] == 1) {
-                g->board[y][x] = EMPTY_TILE;
-            }
-        }
-    }
-
-    start_gravity(g);
+void stop_cascade_event(Game* g) {
+    apply_cascade_event(&g->board, &g->cascade, g->cascadeEvent);
+    g->cascadeEvent++;
+    start_cascade_event(g);
 }
 
 //-----------------------------------------------------------------------------
 
 void start_move(Game* g, uint8_t direction) {
+    g->layerRev++;
     if(!g->solutionMode) {
-        g->undoMovable = g->currentMovable;
-        copy_level(g->boardUndo, g->board);
+        copy_level(g->boardBeforeMove, g->board);
         g->gameMoves++;
     }
     g->move.dir = direction;
     g->move.x = coord_x(g->currentMovable);
     g->move.y = coord_y(g->currentMovable);
-    g->move.frameNo = 0;
     if(!g->solutionMode) {
         g->nextMovable =
             coord_from((g->move.x + ((direction == MOVABLE_LEFT) ? -1 : 1)), g->move.y);
     }
-    g->state = MOVE_SIDES;
+
+    // whole cascade is worked out up front, then played event by event
+    copy_level(g->boardAfterMove, g->board);
+    resolve_move(&g->boardAfterMove, g->move.x, g->move.y, direction, &g->cascade);
+    g->cascadeEvent = 0;
+    start_cascade_event(g);
+
+    if(g->settings.turbo) {
+        settle_instantly(g);
+    }
 }
 
 //-----------------------------------------------------------------------------
 
-void stop_move(Game* g) {
-    uint8_t deltaX = ((g->move.dir & MOVABLE_LEFT) != 0) ? -1 : 1;
-    uint8_t tile = g->board[g->move.y][g->move.x];
+void settle_instantly(Game* g) {
+    bool exploded = false;
 
-    g->board[g->move.y][g->move.x] = EMPTY_TILE;
-    g->board[g->move.y][cap_x(g->move.x + deltaX)] = tile;
+    if(!is_state_animating(g->state)) return;
 
-    start_gravity(g);
+    // rest of cascade, exploding cells kept for the flash
+    clear_animated(g);
+    for(; g->cascadeEvent < g->cascade.eventCount; g->cascadeEvent++) {
+        if(g->cascade.events[g->cascadeEvent].kind == CascadeExplode) {
+            add_animated(g, g->cascadeEvent);
+            exploded = true;
+        }
+    }
+    copy_level(g->board, g->boardAfterMove);
+
+    g->layerRev++;
+    g->flashSteps = exploded ? FLASH_STEPS : 0;
+    g->state = SELECT_BRICK;
+    movement_stoped(g);
+}
+
+//-----------------------------------------------------------------------------
+
+void update_movables(Game* g) {
+    generate_moves(&g->board, &g->moves);
+    map_moves(&g->moves, &g->movables);
+    build_navigation(&g->navigation, &g->movables);
 }
 
 //-----------------------------------------------------------------------------
@@ -512,41 +679,60 @@ void movement_stoped(Game* g) {
     if(g->solutionMode) {
         solution_next(g);
     } else {
-        map_movability(&g->board, &g->movables);
+        update_movables(g);
         update_board_stats(&g->board, g->stats);
         g->currentMovable = g->nextMovable;
         g->nextMovable = MOVABLE_NOT_FOUND;
         if(!is_block(g->board[coord_y(g->currentMovable)][coord_x(g->currentMovable)])) {
-            find_movable_down(&g->movables, &g->currentMovable);
+            navigate(&g->navigation, NavDown, &g->currentMovable);
         }
         if(!is_block(g->board[coord_y(g->currentMovable)][coord_x(g->currentMovable)])) {
-            find_movable_right(&g->movables, &g->currentMovable);
+            navigate(&g->navigation, NavRight, &g->currentMovable);
         }
         if(!is_block(g->board[coord_y(g->currentMovable)][coord_x(g->currentMovable)])) {
             g->currentMovable = MOVABLE_NOT_FOUND;
         }
 
-        g->gameOverReason = is_game_over(&g->movables, g->stats);
+        history_push(
+            &g->history,
+            &g->boardBeforeMove,
+            &g->board,
+            coord_from(g->move.x, g->move.y),
+            g->currentMovable);
+        check_board_result(g);
+    }
+}
 
-        if(g->gameOverReason > NOT_GAME_OVER) {
-            g->state = GAME_OVER;
-        } else if(is_level_finished(g->stats)) {
-            g->state = LEVEL_FINISHED;
-            level_finished(g);
-        } else {
-            g->state = SELECT_BRICK;
-        }
+//-----------------------------------------------------------------------------
+
+void check_board_result(Game* g) {
+    g->gameOverReason = is_game_over(&g->moves, g->stats);
+
+    if(g->gameOverReason > NOT_GAME_OVER) {
+        g->state = GAME_OVER;
+    } else if(is_level_finished(g->stats)) {
+        g->state = LEVEL_FINISHED;
+        level_finished(g);
+    } else {
+        g->state = SELECT_BRICK;
     }
 }
 
 //-----------------------------------------------------------------------------
 
 bool undo(Game* g) {
-    if(g->undoMovable != MOVABLE_NOT_FOUND) {
-        g->currentMovable = g->undoMovable;
-        g->undoMovable = MOVABLE_NOT_FOUND;
-        copy_level(g->board, g->boardUndo);
-        map_movability(&g->board, &g->movables);
+    uint8_t movable;
+
+    g->layerRev++;
+    if(history_undo(&g->history, &g->board, &movable)) {
+        // game over is recorded, playing on from an earlier board is a new attempt
+        if(g->state == GAME_OVER) {
+            end_attempt(g);
+            recorder_begin(g->recorder, furi_string_get_cstr(g->levelSet->id), g->currentLevel);
+        }
+        recorder_undo(g->recorder);
+        g->currentMovable = movable;
+        update_movables(g);
         update_board_stats(&g->board, g->stats);
         g->gameMoves--;
         g->state = SELECT_BRICK;
@@ -559,48 +745,61 @@ bool undo(Game* g) {
 
 //-----------------------------------------------------------------------------
 
-uint8_t
-    movable_from_solution(Game* g, const char* solutionStr, uint8_t step, PlayGround* movables) {
-    const char solX = solutionStr[step * 2];
-    const char solY = solutionStr[step * 2 + 1];
+bool redo(Game* g) {
+    uint8_t movable;
 
-    int x, y;
-    uint8_t dir;
-
-    x = solX - 'a';
-    if(solX <= 'Z') {
-        dir = MOVABLE_LEFT;
-        x = solX - 'A';
-    }
-    y = solY - 'a';
-    if(solY <= 'Z') {
-        dir = MOVABLE_RIGHT;
-        y = solY - 'A';
+    g->layerRev++;
+    if(history_redo(&g->history, &g->board, &movable)) {
+        g->currentMovable = movable;
+        update_movables(g);
+        update_board_stats(&g->board, g->stats);
+        g->gameMoves++;
+        // move being redone may have been the one ending the game
+        check_board_result(g);
+        return true;
+    } else {
+        g->state = SELECT_BRICK;
+        return false;
     }
+}
 
-    if(x < 0 || x >= SIZE_X || y < 0 || y >= SIZE_Y) {
-        end_solution(g);
-        return 0;
-    }
+//-----------------------------------------------------------------------------
+
+uint8_t movable_from_solution(Game* g, uint8_t step, PlayGround* movables) {
+    SolutionStep* solutionStep = &g->levelData->solutionSteps.steps[step];
 
     clear_board(movables);
-    (*movables)[y][x] = dir;
+    (*movables)[coord_y(solutionStep->coord)][coord_x(solutionStep->coord)] = solutionStep->dir;
 
-    return coord_from(x, y);
+    return solutionStep->coord;
 }
 
 //-----------------------------------------------------------------------------
 
 void start_solution(Game* g) {
+    // broken solution was already found out at level load
+    if(!g->levelData->solutionSteps.valid) return;
+
+    g->layerRev++;
     copy_level(g->boardBackup, g->board);
+    copy_level(g->board, g->levelData->initialBoard);
+    recorder_solution_viewed(g->recorder);
 
-    clear_board(&g->board);
-    load_game_board(g);
+    // replayed once per level, watching it again reuses the track
+    if(!g->levelData->solutionDecoded) {
+        build_solution_track(
+            &g->levelData->solutionTrack,
+            &g->levelData->initialBoard,
+            &g->levelData->solutionSteps);
+        g->levelData->solutionDecoded = true;
+    }
 
     g->currentMovableBackup = g->currentMovable;
     g->solutionStep = 0;
-    g->solutionTotal = furi_string_size(g->levelData->solution) / 2;
+    g->solutionTotal = g->levelData->solutionTrack.stepCount;
     g->solutionMode = true;
+    g->solutionPaused = false;
+    g->solutionSpeed = g->settings.turbo ? SOLUTION_SPEEDS - 1 : SOLUTION_SPEED_NORMAL;
     if(solution_will_have_penalty(g)) {
         g->levelSet->scores[g->currentLevel].spoiled = true;
         save_set_scores(g->levelSet->id, g->levelSet->scores);
@@ -612,40 +811,71 @@ void start_solution(Game* g) {
 //-----------------------------------------------------------------------------
 
 void end_solution(Game* g) {
+    g->layerRev++;
     g->state = SELECT_BRICK;
     g->currentMovable = g->currentMovableBackup;
     copy_level(g->board, g->boardBackup);
-    clear_board(&g->toAnimate);
-    map_movability(&g->board, &g->movables);
+    clear_animated(g);
+    update_movables(g);
     update_board_stats(&g->board, g->stats);
     g->solutionMode = false;
 }
 
 //-----------------------------------------------------------------------------
 
+static const uint8_t solutionDelays[SOLUTION_SPEEDS] = {70, 35, 16, 8};
+
 void solution_select(Game* g) {
-    g->currentMovable = movable_from_solution(
-        g, furi_string_get_cstr(g->levelData->solution), g->solutionStep, &g->movables);
-    g->move.frameNo = 35;
     g->state = SOLUTION_SELECT;
+
+    if(g->solutionStep >= g->solutionTotal) {
+        // stay on final board, so it can be scrubbed back
+        g->currentMovable = MOVABLE_NOT_FOUND;
+        clear_board(&g->movables);
+        g->solutionPaused = true;
+        return;
+    }
+
+    g->currentMovable = movable_from_solution(g, g->solutionStep, &g->movables);
+    g->move.frameNo = solutionDelays[g->solutionSpeed];
 }
 
 //-----------------------------------------------------------------------------
 
 void solution_move(Game* g) {
     const uint8_t dir = movable_dir(&g->movables, g->currentMovable);
+    if(!is_block(g->board[coord_y(g->currentMovable)][coord_x(g->currentMovable)])) {
+        // idle step in stored solution, nothing to animate
+        solution_next(g);
+        return;
+    }
     start_move(g, dir);
 }
 
 //-----------------------------------------------------------------------------
 
+static void solution_goto(Game* g, uint8_t step) {
+    g->layerRev++;
+    g->solutionStep = MIN(step, g->solutionTotal);
+    solution_board_at(&g->levelData->solutionTrack, g->solutionStep, &g->board);
+    solution_select(g);
+}
+
+//-----------------------------------------------------------------------------
+
 void solution_next(Game* g) {
-    if(g->solutionStep < g->solutionTotal - 1) {
-        g->solutionStep++;
-        solution_select(g);
-    } else {
-        end_solution(g);
-    }
+    // board after animation is the same, but the track is the reference
+    solution_goto(g, g->solutionStep + 1);
+}
+
+//-----------------------------------------------------------------------------
+
+void solution_seek(Game* g, uint8_t step) {
+    // drop whatever was being animated
+    clear_animated(g);
+    g->flashSteps = 0;
+    g->solutionPaused = true;
+    solution_goto(g, step);
 }
 
 //-----------------------------------------------------------------------------
@@ -654,3 +884,109 @@ bool solution_will_have_penalty(Game* g) {
     return (g->levelSet->scores[g->currentLevel].moves == 0) &&
            (!g->levelSet->scores[g->currentLevel].spoiled);
 }
+
+//-----------------------------------------------------------------------------
+
+static void step_intro(Game* g) {
+    if(g->move.frameNo == 24) {
+        g->state = MAIN_MENU;
+        return;
+    }
+    if((g->simStep % 2 == 1) && (g->move.frameNo < 100)) {
+        g->move.frameNo++;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+static void step_about(Game* g) {
+    if(g->simStep % 10 == 9) {
+        randomize_bg(&g->bg);
+    }
+
+    if(g->simStep % 50 == 49) {
+        g->bgShiftX = rand() % 7;
+        g->bgShiftY = rand() % 7;
+        randomize_bg(&g->bg);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void game_step(Game* g) {
+    if(g->flashSteps > 0) {
+        g->flashSteps--;
+    }
+
+    switch(g->state) {
+    case INTRO:
+        step_intro(g);
+        break;
+    case ABOUT:
+        step_about(g);
+        break;
+    case SOLUTION_SELECT:
+        if(g->solutionPaused) break;
+        g->move.frameNo--;
+        if(g->move.frameNo == 0) {
+            solution_move(g);
+        }
+        break;
+    case MOVE_SIDES:
+        g->move.frameNo++;
+        if(g->move.frameNo > TILE_SIZE) {
+            stop_cascade_event(g);
+        }
+        break;
+    case MOVE_GRAVITY:
+        if(g->move.delay > 0) {
+            g->move.delay--;
+            break;
+        }
+        g->move.frameNo++;
+        if(g->move.frameNo > TILE_SIZE) {
+            stop_cascade_event(g);
+        }
+        break;
+    case EXPLODE:
+        if(g->move.delay > 0) {
+            g->move.delay--;
+            break;
+        }
+        g->move.frameNo++;
+        if(g->move.frameNo > 10) {
+            stop_cascade_event(g);
+        }
+        break;
+    default:
+        break;
+    }
+
+    g->simStep++;
+}
+
+//-----------------------------------------------------------------------------
+
+void run_simulation(Game* g) {
+    const uint32_t stepTicks = furi_kernel_get_tick_frequency() / SIM_STEPS_PER_SECOND;
+    const uint32_t now = furi_get_tick();
+    uint8_t steps = 0;
+
+    // catch up on late ticks so speed does not depend on redraw rate,
+    // but give up when too far behind instead of fast-forwarding
+    while((now - g->simTick) >= stepTicks) {
+        if(steps == SIM_MAX_CATCHUP) {
+            g->simTick = now;
+            break;
+        }
+        game_step(g);
+        g->simTick += stepTicks;
+        steps++;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void reset_simulation_clock(Game* g) {
+    g->simTick = furi_get_tick();
+}
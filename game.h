@@ -6,6 +6,12 @@
 #include "common.h"
 #include "load.h"
 #include "stats.h"
+#include "profiler.h"
+#include "recorder.h"
+#include "solution.h"
+#include "history.h"
+#include "move.h"
+#include "walls.h"
 
 //-----------------------------------------------------------------------------
 
@@ -65,9 +71,13 @@ typedef struct {
     u_int32_t delay;
 } MoveInfo;
 
+typedef struct {
+    InputEvent event;
+    uint8_t count; // repeats of a held key fold into one entry, 1 for others
+} InputAhead;
+
 typedef struct {
     ViewPort* viewPort;
-    FuriMutex* mutex;
     State state;
 
     LevelSet* levelSet;
@@ -81,9 +91,20 @@ typedef struct {
 
     // board
     PlayGround board;
-    PlayGround boardUndo;
+    PlayGround boardBeforeMove;
+    PlayGround boardAfterMove;
+    History history;
+    CascadeLog cascade;
+    uint8_t cascadeEvent;
     PlayGround toAnimate;
+    uint8_t animatedCells[SIZE_X * SIZE_Y]; // same cells as toAnimate, listed
+    uint8_t animatedCount;
+    MoveList moves;
     PlayGround movables;
+    NavigationTable navigation;
+    WallGeometry walls;
+    uint32_t layerRev;
+    uint32_t levelRev;
 
     // solution
     PlayGround boardBackup;
@@ -91,12 +112,14 @@ typedef struct {
     bool solutionMode;
     uint8_t solutionStep;
     uint8_t solutionTotal;
+    bool solutionPaused;
+    uint8_t solutionSpeed;
 
     // board stats
     Stats* stats;
 
     // selections
-    uint8_t undoMovable;
+    bool okArmed;
     uint8_t currentMovable;
     uint8_t nextMovable;
 
@@ -116,6 +139,15 @@ typedef struct {
     // game state
     GameOver gameOverReason;
     MoveInfo move;
+    uint32_t simTick;
+    uint32_t simStep;
+    uint8_t bgShiftX;
+    uint8_t bgShiftY;
+    uint8_t flashSteps;
+    Settings settings;
+    InputAhead inputAhead[INPUT_AHEAD_SIZE];
+    uint8_t inputAheadCount;
+    uint32_t suspendedHash; // of game last suspended to SD, 0 if none
 
     // extra levels
     LevelList levelList;
@@ -123,6 +155,9 @@ typedef struct {
     FuriString* errorMsg;
     BackGround bg;
 
+    // diagnostics
+    Profiler profiler;
+    Recorder* recorder;
 } Game;
 
 //-----------------------------------------------------------------------------
@@ -133,7 +168,7 @@ void free_game_state(Game* game);
 //-----------------------------------------------------------------------------
 
 void new_game(Game* game);
-GameOver is_game_over(PlayGround* mv, Stats* stats);
+GameOver is_game_over(MoveList* moves, Stats* stats);
 bool is_level_finished(Stats* stats);
 Neighbors find_neighbors(PlayGround* pg, uint8_t x, uint8_t y);
 
@@ -143,10 +178,13 @@ const char* level_on_pos(Game* game, int pos);
 int level_count(Game* game);
 void handle_ivalid_set(Game* game, Storage* storage, FuriString* setId, FuriString* errorMsg);
 void initial_load_game(Game* game);
+void suspend_game(Game* g);
+void resume_game(Game* g);
 void load_gameset_if_needed(Game* game, FuriString* expectedSet);
 void start_game_at_level(Game* game, uint8_t levelNo);
 void refresh_level(Game* g);
 void level_finished(Game* g);
+void end_attempt(Game* g);
 void forget_continue(Game* g);
 void score_for_level(Game* g, uint8_t levelNo, char* buf, size_t max);
 
@@ -154,15 +192,17 @@ void score_for_level(Game* g, uint8_t levelNo, char* buf, size_t max);
 
 void click_selected(Game* game);
 
-void start_gravity(Game* g);
-void stop_gravity(Game* g);
-void start_explosion(Game* g);
-void stop_explosion(Game* g);
+void clear_animated(Game* g);
+void start_cascade_event(Game* g);
+void stop_cascade_event(Game* g);
 void start_move(Game* g, uint8_t direction);
-void stop_move(Game* g);
+void settle_instantly(Game* g);
 
+void update_movables(Game* g);
 void movement_stoped(Game* g);
+void check_board_result(Game* g);
 bool undo(Game* g);
+bool redo(Game* g);
 
 //-----------------------------------------------------------------------------
 
@@ -171,4 +211,11 @@ void end_solution(Game* g);
 void solution_select(Game* g);
 void solution_move(Game* g);
 void solution_next(Game* g);
+void solution_seek(Game* g, uint8_t step);
 bool solution_will_have_penalty(Game* g);
+
+//-----------------------------------------------------------------------------
+
+void game_step(Game* g);
+void run_simulation(Game* g);
+void reset_simulation_clock(Game* g);
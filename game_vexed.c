@@ -14,29 +14,72 @@
 #include "move.h"
 #include "fonts.h"
 #include "ui.h"
+#include "render.h"
 #include "draw.h"
 #include "events.h"
+#include "profiler.h"
 
 //-----------------------------------------------------------------------------
 
 void game_tick(void* ctx) {
     furi_assert(ctx);
-    const Game* game = ctx;
-    view_port_update(game->viewPort);
+    FuriMessageQueue* event_queue = ctx;
+    GameEvent event = {.type = EventTypeTick};
+    // a tick still waiting in queue is as good as a new one
+    furi_message_queue_put(event_queue, &event, 0);
 }
 
 static void app_input_callback(InputEvent* input_event, void* ctx) {
     furi_assert(ctx);
     FuriMessageQueue* event_queue = ctx;
-    furi_message_queue_put(event_queue, input_event, FuriWaitForever);
+    GameEvent event = {.type = EventTypeKey, .input = *input_event};
+    furi_message_queue_put(event_queue, &event, FuriWaitForever);
 }
 
+// draws last published snapshot, game itself is never touched here
 static void app_draw_callback(Canvas* canvas, void* ctx) {
     furi_assert(ctx);
-    Game* game = ctx;
-    furi_mutex_acquire(game->mutex, FuriWaitForever);
-    draw_app(canvas, game);
-    furi_mutex_release(game->mutex);
+    Renderer* render = ctx;
+    RenderSnapshot* view = acquire_snapshot(render);
+    if(view == NULL) {
+        return;
+    }
+
+    profiler_frame(&render->drawProfile, view->state, view->framePeriod);
+
+    const uint32_t drawStart = profiler_now(&render->drawProfile);
+    draw_app(canvas, render, view);
+    profiler_record(&render->drawProfile, view->state, ProfileDraw, drawStart);
+    release_snapshot(render);
+}
+
+//-----------------------------------------------------------------------------
+
+// returns false when the key asks to leave the app
+static bool app_handle_key(Game* game, Renderer* render, InputEvent* input) {
+    // keys finishing the profiler combo do not reach the game
+    switch(profiler_combo(&game->profiler, input)) {
+    case ProfilerActionToggle:
+        game->profiler.overlay = !game->profiler.overlay;
+        return true;
+    case ProfilerActionDump:
+        profiler_dump(&game->profiler, &render->drawProfile);
+        return true;
+    case ProfilerActionSwallow:
+        // held key may have queued its press while bricks were moving
+        if(input->type == InputTypeLong) drop_input_ahead(game, input->key);
+        return true;
+    default:
+        break;
+    }
+
+    if(((input->type == InputTypeLong) && (input->key == InputKeyBack)) ||
+       ((game->state == ABOUT) && (input->key == InputKeyOk))) {
+        return false;
+    }
+
+    events_for_game(input, game);
+    return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -45,69 +88,90 @@ int32_t game_vexed_app(void* p) {
     UNUSED(p);
     int error;
     bool running = true;
-    bool paused = false;
-    InputEvent event;
+    uint32_t framePeriod = 0;
+    GameEvent event;
 
     Game* game = alloc_game_state(&error);
     if(error > 0) {
         return error;
     }
 
-    FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
+    FuriMessageQueue* event_queue = furi_message_queue_alloc(EVENT_QUEUE_SIZE, sizeof(GameEvent));
+    Renderer* render = alloc_renderer();
 
     // Configure view port
     game->viewPort = view_port_alloc();
-    view_port_draw_callback_set(game->viewPort, app_draw_callback, game);
+    view_port_draw_callback_set(game->viewPort, app_draw_callback, render);
     view_port_input_callback_set(game->viewPort, app_input_callback, event_queue);
 
     // Register view port in GUI
     Gui* gui = furi_record_open(RECORD_GUI);
     gui_add_view_port(gui, game->viewPort, GuiLayerFullscreen);
 
-    // Create a timer. When non-paused, it trigers UI refresh
-    FuriTimer* timer = furi_timer_alloc(game_tick, FuriTimerTypePeriodic, game);
-    furi_timer_start(timer, furi_kernel_get_tick_frequency() / 20);
+    // Create a timer. When non-paused, it advances the simulation and trigers
+    // UI refresh - at full rate for animations, slower while only selection blinks
+    FuriTimer* timer = furi_timer_alloc(game_tick, FuriTimerTypePeriodic, event_queue);
 
     initial_load_game(game);
+    publish_snapshot(render, game);
+    view_port_update(game->viewPort);
+
+    framePeriod = frame_period(game);
+    if(framePeriod > 0) {
+        reset_simulation_clock(game);
+        furi_timer_start(timer, framePeriod);
+    }
 
     while(running) {
         FuriStatus event_status = furi_message_queue_get(event_queue, &event, FuriWaitForever);
 
         if(event_status == FuriStatusOk) {
-            furi_mutex_acquire(game->mutex, FuriWaitForever);
+            const State state = game->state;
+            const uint32_t eventStart = profiler_now(&game->profiler);
+
+            // everything queued meanwhile is handled in one go, so held
+            // keys cost one lock and one redraw however many repeats came
+            do {
+                if(event.type == EventTypeKey) {
+                    running = app_handle_key(game, render, &event.input);
+                } else {
+                    run_simulation(game);
+                }
+                replay_input_ahead(game);
+            } while(running && (furi_message_queue_get(event_queue, &event, 0) == FuriStatusOk));
 
-            if(((event.type == InputTypeLong) && (event.key == InputKeyBack)) ||
-               ((game->state == ABOUT) && (event.key == InputKeyOk))) {
-                running = false;
-            } else {
-                events_for_game(&event, game);
-            }
+            profiler_record(&game->profiler, state, ProfileEvent, eventStart);
 
-            bool shouldBePaused = is_state_pause(game->state);
+            // animations end in simulation steps, so rate is checked on ticks too
+            const uint32_t shouldBePeriod = frame_period(game);
 
-            if(paused != shouldBePaused) {
-                paused = shouldBePaused;
-                if(paused) {
+            if(framePeriod != shouldBePeriod) {
+                framePeriod = shouldBePeriod;
+                if(framePeriod == 0) {
                     furi_timer_stop(timer);
                     FURI_LOG_D(TAG, "PAUSE - timer stoped");
                 } else {
-                    furi_timer_start(timer, furi_kernel_get_tick_frequency() / 20);
+                    reset_simulation_clock(game);
+                    furi_timer_start(timer, framePeriod);
                     FURI_LOG_D(TAG, "UNPAUSE - timer started");
                 }
             }
 
-            if(shouldBePaused) {
-                view_port_update(game->viewPort);
-            }
-            furi_mutex_release(game->mutex);
+            // redraw right away, do not wait for next tick
+            publish_snapshot(render, game);
+            view_port_update(game->viewPort);
         }
     }
 
     furi_timer_free(timer);
+    // unfinished level is picked up on next launch
+    suspend_game(game);
+    end_attempt(game);
     view_port_enabled_set(game->viewPort, false);
     gui_remove_view_port(gui, game->viewPort);
     furi_message_queue_free(event_queue);
     free_game_state(game);
+    free_renderer(render);
     furi_record_close(RECORD_GUI);
 
     return 0;
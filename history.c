@@ -0,0 +1,134 @@
+#include "history.h"
+
+// positions only grow, ring index is taken when reading or writing
+#define WORD_AT(h, pos) ((h)->words[(pos) % HISTORY_WORDS])
+
+//-----------------------------------------------------------------------------
+
+void init_history(History* h) {
+    h->start = 0;
+    h->top = 0;
+    h->end = 0;
+}
+
+//-----------------------------------------------------------------------------
+
+bool history_can_undo(History* h) {
+    return h->top != h->start;
+}
+
+//-----------------------------------------------------------------------------
+
+bool history_can_redo(History* h) {
+    return h->top != h->end;
+}
+
+//-----------------------------------------------------------------------------
+
+bool history_valid(History* h) {
+    uint32_t pos = h->start;
+    uint16_t i, count, change;
+    bool topSeen = (h->top == h->start);
+
+    if((h->top < h->start) || (h->end < h->top) || ((h->end - h->start) > HISTORY_WORDS)) {
+        return false;
+    }
+
+    // every record must be framed the same on both ends, fit the board and
+    // have a boundary where top points
+    while(pos < h->end) {
+        count = HISTORY_FRAME_COUNT(WORD_AT(h, pos));
+        if((pos + count + 2) > h->end) return false;
+        if(HISTORY_FRAME_COUNT(WORD_AT(h, pos + count + 1)) != count) return false;
+
+        for(i = 0; i < count; i++) {
+            change = WORD_AT(h, pos + 1 + i);
+            if(HISTORY_CHANGE_CELL(change) >= SIZE_X * SIZE_Y) return false;
+            if(HISTORY_CHANGE_BEFORE(change) > WALL_TILE) return false;
+            if(HISTORY_CHANGE_AFTER(change) > WALL_TILE) return false;
+        }
+
+        pos += count + 2;
+        if(pos == h->top) topSeen = true;
+    }
+
+    return topSeen;
+}
+
+//-----------------------------------------------------------------------------
+
+void history_push(
+    History* h,
+    PlayGround* before,
+    PlayGround* after,
+    uint8_t movableBefore,
+    uint8_t movableAfter) {
+    uint8_t x, y;
+    uint16_t count = 0;
+
+    for(y = 0; y < SIZE_Y; y++) {
+        for(x = 0; x < SIZE_X; x++) {
+            if((*before)[y][x] != (*after)[y][x]) count++;
+        }
+    }
+
+    // new move forgets everything undone, then makes room for itself
+    h->end = h->top;
+    while((h->end + count + 2 - h->start) > HISTORY_WORDS) {
+        h->start += HISTORY_FRAME_COUNT(WORD_AT(h, h->start)) + 2;
+    }
+
+    WORD_AT(h, h->end++) = HISTORY_FRAME(movableBefore, count);
+    for(y = 0; y < SIZE_Y; y++) {
+        for(x = 0; x < SIZE_X; x++) {
+            if((*before)[y][x] != (*after)[y][x]) {
+                WORD_AT(h, h->end++) =
+                    HISTORY_CHANGE(y * SIZE_X + x, (*before)[y][x], (*after)[y][x]);
+            }
+        }
+    }
+    WORD_AT(h, h->end++) = HISTORY_FRAME(movableAfter, count);
+    h->top = h->end;
+}
+
+//-----------------------------------------------------------------------------
+
+bool history_undo(History* h, PlayGround* pg, uint8_t* movable) {
+    uint8_t* cells = &(*pg)[0][0];
+    uint16_t i, change;
+
+    if(!history_can_undo(h)) return false;
+
+    const uint16_t count = HISTORY_FRAME_COUNT(WORD_AT(h, h->top - 1));
+    const uint32_t first = h->top - 1 - count;
+
+    for(i = 0; i < count; i++) {
+        change = WORD_AT(h, first + i);
+        cells[HISTORY_CHANGE_CELL(change)] = HISTORY_CHANGE_BEFORE(change);
+    }
+
+    *movable = HISTORY_FRAME_MOVABLE(WORD_AT(h, first - 1));
+    h->top = first - 1;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool history_redo(History* h, PlayGround* pg, uint8_t* movable) {
+    uint8_t* cells = &(*pg)[0][0];
+    uint16_t i, change;
+
+    if(!history_can_redo(h)) return false;
+
+    const uint16_t count = HISTORY_FRAME_COUNT(WORD_AT(h, h->top));
+    const uint32_t first = h->top + 1;
+
+    for(i = 0; i < count; i++) {
+        change = WORD_AT(h, first + i);
+        cells[HISTORY_CHANGE_CELL(change)] = HISTORY_CHANGE_AFTER(change);
+    }
+
+    *movable = HISTORY_FRAME_MOVABLE(WORD_AT(h, first + count));
+    h->top = first + count + 1;
+    return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "common.h"
+
+// Undo and redo history of played moves.
+//
+// A move is kept as the cells its whole cascade changed, each with tile
+// before and after, so it is undone or redone without replaying anything.
+// Records are framed on both ends by a word holding the change count, so
+// they can be walked in either direction, and live in a fixed ring - once
+// it is full, the oldest moves are forgotten.
+
+#define HISTORY_WORDS 1024 // 2 KiB, hundreds of moves on a typical board
+
+#define HISTORY_CHANGE(cell, before, after) \
+    ((uint16_t)((cell) | ((before) << 8) | ((after) << 12)))
+#define HISTORY_CHANGE_CELL(change) ((change) & 0xFF)
+#define HISTORY_CHANGE_BEFORE(change) (((change) >> 8) & 0x0F)
+#define HISTORY_CHANGE_AFTER(change) ((change) >> 12)
+
+// movable selected before the move in leading frame, after it in trailing one
+#define HISTORY_FRAME(movable, count) ((uint16_t)((movable) | ((count) << 8)))
+#define HISTORY_FRAME_MOVABLE(frame) ((frame) & 0xFF)
+#define HISTORY_FRAME_COUNT(frame) ((frame) >> 8)
+
+typedef struct {
+    uint16_t words[HISTORY_WORDS];
+    uint32_t start; // first word of oldest move kept
+    uint32_t top; // end of last move played, or undone up to
+    uint32_t end; // end of last move that can be redone
+} History;
+
+//-----------------------------------------------------------------------------
+
+void init_history(History* h);
+bool history_can_undo(History* h);
+bool history_can_redo(History* h);
+bool history_valid(History* h);
+
+void history_push(
+    History* h,
+    PlayGround* before,
+    PlayGround* after,
+    uint8_t movableBefore,
+    uint8_t movableAfter);
+bool history_undo(History* h, PlayGround* pg, uint8_t* movable);
+bool history_redo(History* h, PlayGround* pg, uint8_t* movable);
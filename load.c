@@ -8,13 +8,6 @@
 #include <toolbox/stream/stream.h>
 #include <toolbox/stream/file_stream.h>
 
-// i overwrite it because this: https://github.com/flipperdevices/flipperzero-firmware/blob/a7b60bf2a610e1a364d26a925f3713c08d16d49c/applications/services/storage/storage_processing.c#L530
-// gets me gui thread instead of app thread
-
-#define MY_APP_DATA_PATH(path)  \
-    "/ext/apps_data/game_vexed" \
-    "/" path
-
 char* assetLevels[] = {
     "01 Classic Levels",
     "02 Classic Levels 2",
@@ -34,6 +27,13 @@ LevelData* alloc_level_data() {
     ld->board = furi_string_alloc();
     ld->title = furi_string_alloc();
     ld->gamePar = 0;
+    ld->setId = furi_string_alloc();
+    ld->level = 0;
+    ld->parsed = false;
+    ld->solutionSteps.count = 0;
+    ld->solutionSteps.valid = false;
+    ld->solutionDecoded = false;
+    init_solution_track(&ld->solutionTrack);
     return ld;
 }
 
@@ -41,6 +41,8 @@ void free_level_data(LevelData* ld) {
     furi_string_free(ld->solution);
     furi_string_free(ld->board);
     furi_string_free(ld->title);
+    furi_string_free(ld->setId);
+    free_solution_track(&ld->solutionTrack);
     free(ld);
 }
 
@@ -148,112 +150,6 @@ bool level_set_id_to_score_path(
 
 //-----------------------------------------------------------------------------
 
-int load_level_row(uint8_t* pb, const char* psz, const char* pszMax) {
-    int cBlocks = 0;
-    for(; psz < pszMax; psz++) {
-        char ch = *psz;
-
-        // Is this a number (non-moveable blocks?)
-
-        int c = 0;
-        while(ch >= '0' && ch <= '9') {
-            c = c * 10 + ch - '0';
-            psz++;
-            if(psz >= pszMax) break;
-            ch = *psz;
-        }
-        if(c != 0) {
-            cBlocks += c;
-            if(pb != NULL) {
-                while(c != 0) {
-                    *pb++ = 9;
-                    c--;
-                }
-            }
-            psz--;
-            continue;
-        }
-
-        // Is this empty space?
-
-        if(ch == '~') {
-            cBlocks++;
-            if(pb != NULL) *pb++ = 0;
-            continue;
-        }
-
-        // This is a block type. Remember it verbatim
-
-        if(ch < 'a' || ch > 'h') return -1;
-
-        cBlocks++;
-        if(pb != NULL) *pb++ = ch - 'a' + 1;
-    }
-
-    return cBlocks;
-}
-
-//-----------------------------------------------------------------------------
-
-bool parse_level_notation(const char* pszLevel, PlayGround* level) {
-    uint8_t* pbLoad;
-
-    const char* pszLast = pszLevel;
-    bool fLoop = true;
-    int cRows = 0;
-    int cCols = -1;
-    while(fLoop) {
-        int cColsT;
-        const char* pszNext = strchr(pszLast, '/');
-        if(pszNext == NULL) {
-            pszNext = pszLast + strlen(pszLast);
-            fLoop = false;
-        }
-        cColsT = load_level_row(NULL, pszLast, pszNext);
-        if(cCols == -1) {
-            cCols = cColsT;
-        } else if(cCols != cColsT) {
-            return false;
-        }
-        cRows++;
-        pszLast = pszNext + 1;
-    }
-
-    // Vexed wants these sizes
-
-    if(cCols != SIZE_X || cRows != SIZE_Y) return false;
-
-    // Load it this time
-
-    memset(level, '\0', sizeof(uint8_t) * SIZE_X * SIZE_Y);
-
-    pbLoad = level[0][0];
-    pszLast = pszLevel;
-    fLoop = true;
-    while(fLoop) {
-        // Find the end of this row
-
-        const char* pszNext = strchr(pszLast, '/');
-        if(pszNext == NULL) {
-            pszNext = pszLast + strlen(pszLast);
-            fLoop = false;
-        }
-
-        // Load the row
-
-        load_level_row(pbLoad, pszLast, pszNext);
-
-        // Next row...
-
-        pbLoad += SIZE_X;
-        pszLast = pszNext + 1;
-    }
-
-    return true;
-}
-
-//-----------------------------------------------------------------------------
-
 bool load_level(
     Storage* storage,
     FuriString* levelSetId,
@@ -731,6 +627,127 @@ void delete_progress(LevelScore* scores) {
 
 //-----------------------------------------------------------------------------
 
+void load_settings(Settings* settings) {
+    memset(settings, 0, sizeof(Settings));
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(storage_common_exists(storage, MY_APP_DATA_PATH("settings.txt"))) {
+        FuriString* fbuf = furi_string_alloc();
+        File* file = storage_file_alloc(storage);
+
+        if(storage_file_open(
+               file, MY_APP_DATA_PATH("settings.txt"), FSAM_READ, FSOM_OPEN_EXISTING)) {
+            load_all(file, fbuf);
+            storage_file_close(file);
+
+            // one "name value" pair per line
+            settings->turbo = (furi_string_search_str(fbuf, "turbo 1", 0) != FURI_STRING_FAILURE);
+        } else {
+            FURI_LOG_E(TAG, "Failed to open settings file");
+        }
+
+        storage_file_free(file);
+        furi_string_free(fbuf);
+    }
+    furi_record_close(RECORD_STORAGE);
+}
+
+//-----------------------------------------------------------------------------
+
+bool save_settings(Settings* settings) {
+    const int bufSize = 64;
+    char buf[bufSize];
+    bool saved = false;
+
+    snprintf(buf, sizeof(buf), "turbo %u\n", settings->turbo ? 1 : 0);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(ensure_paths(storage)) {
+        File* file = storage_file_alloc(storage);
+
+        if(storage_file_open(
+               file, MY_APP_DATA_PATH("settings.txt"), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            saved = storage_file_write(file, buf, strlen(buf)) == strlen(buf);
+            storage_file_close(file);
+        }
+        if(!saved) {
+            FURI_LOG_E(TAG, "Failed to write settings file");
+        }
+        storage_file_free(file);
+    }
+    furi_record_close(RECORD_STORAGE);
+    return saved;
+}
+
+//-----------------------------------------------------------------------------
+
+bool load_suspended(SuspendedGame* suspended) {
+    bool loaded = false;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(storage_common_exists(storage, MY_APP_DATA_PATH("suspended.bin"))) {
+        File* file = storage_file_alloc(storage);
+
+        if(storage_file_open(
+               file, MY_APP_DATA_PATH("suspended.bin"), FSAM_READ, FSOM_OPEN_EXISTING)) {
+            loaded = storage_file_read(file, suspended, sizeof(SuspendedGame)) ==
+                     sizeof(SuspendedGame);
+            storage_file_close(file);
+        }
+        storage_file_free(file);
+    }
+    furi_record_close(RECORD_STORAGE);
+
+    // written by other version, or cut short
+    if(loaded && ((suspended->magic != SUSPEND_MAGIC) || (suspended->version != SUSPEND_VERSION) ||
+                  (suspended->size != sizeof(SuspendedGame)))) {
+        FURI_LOG_W(TAG, "Suspended game not compatible");
+        loaded = false;
+    }
+
+    return loaded;
+}
+
+//-----------------------------------------------------------------------------
+
+bool save_suspended(SuspendedGame* suspended) {
+    bool saved = false;
+
+    suspended->magic = SUSPEND_MAGIC;
+    suspended->version = SUSPEND_VERSION;
+    suspended->size = sizeof(SuspendedGame);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(ensure_paths(storage)) {
+        File* file = storage_file_alloc(storage);
+
+        if(storage_file_open(
+               file, MY_APP_DATA_PATH("suspended.bin"), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            saved = storage_file_write(file, suspended, sizeof(SuspendedGame)) ==
+                    sizeof(SuspendedGame);
+            storage_file_close(file);
+        }
+        if(!saved) {
+            FURI_LOG_E(TAG, "Failed to write suspended game");
+        }
+        storage_file_free(file);
+    }
+    furi_record_close(RECORD_STORAGE);
+    return saved;
+}
+
+//-----------------------------------------------------------------------------
+
+void forget_suspended() {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(storage_common_exists(storage, MY_APP_DATA_PATH("suspended.bin"))) {
+        storage_common_remove(storage, MY_APP_DATA_PATH("suspended.bin"));
+    }
+    furi_record_close(RECORD_STORAGE);
+}
+
+//-----------------------------------------------------------------------------
+
 void init_level_list(LevelList* ls, int capacity) {
     ls->count = capacity;
     if(capacity > 0) {
@@ -2,10 +2,20 @@
 
 #include <storage/storage.h>
 #include "common.h"
+#include "engine.h"
+#include "history.h"
+#include "solution.h"
 
 #define ASSETS_LEVELS_COUNT 9
 #define MAX_LEVELS_PER_SET 100
 
+// i overwrite it because this: https://github.com/flipperdevices/flipperzero-firmware/blob/a7b60bf2a610e1a364d26a925f3713c08d16d49c/applications/services/storage/storage_processing.c#L530
+// gets me gui thread instead of app thread
+
+#define MY_APP_DATA_PATH(path)  \
+    "/ext/apps_data/game_vexed" \
+    "/" path
+
 extern char* assetLevels[];
 
 typedef struct {
@@ -29,6 +39,16 @@ typedef struct {
     FuriString* board;
     FuriString* title;
     unsigned int gamePar;
+
+    // level above, parsed once - restarting it or showing its solution
+    // copies these instead of reading SD card again
+    FuriString* setId;
+    uint8_t level;
+    bool parsed;
+    PlayGround initialBoard;
+    SolutionSteps solutionSteps;
+    bool solutionDecoded;
+    SolutionTrack solutionTrack;
 } LevelData;
 
 typedef struct {
@@ -36,6 +56,27 @@ typedef struct {
     int count;
 } LevelList;
 
+typedef struct {
+    bool turbo;
+} Settings;
+
+#define SUSPEND_MAGIC 0x53475856 // "VXGS"
+#define SUSPEND_VERSION 1
+#define SUSPEND_SET_ID_SIZE 64
+
+// Level left unfinished, written to SD card as is and read back in one go
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    char setId[SUSPEND_SET_ID_SIZE];
+    uint8_t level;
+    uint8_t currentMovable;
+    uint16_t gameMoves;
+    PlayGround board;
+    History history;
+} SuspendedGame;
+
 //-----------------------------------------------------------------------------
 
 LevelSet* alloc_level_set();
@@ -62,11 +103,14 @@ bool save_last_level(FuriString* lastLevelSetId, uint8_t levelNo);
 bool load_set_scores(Storage* storage, FuriString* levelSetId, LevelScore* scores);
 bool save_set_scores(FuriString* levelSetId, LevelScore* scores);
 void delete_progress(LevelScore* scores);
+void load_settings(Settings* settings);
+bool save_settings(Settings* settings);
+bool load_suspended(SuspendedGame* suspended);
+bool save_suspended(SuspendedGame* suspended);
+void forget_suspended();
 
 //-----------------------------------------------------------------------------
 
-int load_level_row(uint8_t* pb, const char* psz, const char* pszMax);
-bool parse_level_notation(const char* pszLevel, PlayGround* level);
 bool load_level(
     Storage* storage,
     FuriString* levelSetId,
@@ -27,24 +27,6 @@ uint8_t movable_dir(MovabilityTab* mv, uint8_t currentMovable) {
 
 //-----------------------------------------------------------------------------
 
-void map_movability(PlayGround* pg, PlayGround* mv) {
-    uint8_t tile, x, y, movable;
-
-    for(y = 0; y < SIZE_Y; y++) {
-        for(x = 0; x < SIZE_X; x++) {
-            movable = MOVABLE_NOT;
-            tile = (*pg)[y][x];
-            if(is_block(tile)) {
-                if(x > 0 && ((*pg)[y][x - 1] == EMPTY_TILE)) movable += MOVABLE_LEFT;
-                if((x < (SIZE_X - 1)) && ((*pg)[y][x + 1] == EMPTY_TILE)) movable += MOVABLE_RIGHT;
-            }
-            (*mv)[y][x] = movable;
-        }
-    }
-}
-
-//-----------------------------------------------------------------------------
-
 uint8_t find_movable(PlayGround* mv) {
     uint8_t x, y;
     for(y = 0; y < SIZE_Y; y++) {
@@ -87,7 +69,7 @@ void find_movable_left(PlayGround* mv, uint8_t* currentMovable) {
     }
 
     uint8_t x, y;
-    for(y = sy - 1; y > 0; y--) {
+    for(y = sy - 1; (sy > 0) && (y > 0); y--) {
         for(x = SIZE_X - 1; x > 0; x--) {
             if((*mv)[y][x] != MOVABLE_NOT) {
                 *currentMovable = coord_from(x, y);
@@ -208,4 +190,36 @@ void find_movable_up(PlayGround* mv, uint8_t* currentMovable) {
     }
 }
 
+//-----------------------------------------------------------------------------
+
+void build_navigation(NavigationTable* nav, MovabilityTab* mv) {
+    uint8_t from, to;
+
+    // searches above define where selection goes, table only remembers it
+    for(from = 0; from <= NAV_FROM_NOWHERE; from++) {
+        const uint8_t start = (from == NAV_FROM_NOWHERE) ? MOVABLE_NOT_FOUND : from;
+
+        to = start;
+        find_movable_left(mv, &to);
+        nav->next[NavLeft][from] = to;
+
+        to = start;
+        find_movable_right(mv, &to);
+        nav->next[NavRight][from] = to;
+
+        to = start;
+        find_movable_up(mv, &to);
+        nav->next[NavUp][from] = to;
+
+        to = start;
+        find_movable_down(mv, &to);
+        nav->next[NavDown][from] = to;
+    }
+}
+
+//-----------------------------------------------------------------------------
 
+void navigate(NavigationTable* nav, NavDirection dir, uint8_t* currentMovable) {
+    const uint8_t from = (*currentMovable < NAV_FROM_NOWHERE) ? *currentMovable : NAV_FROM_NOWHERE;
+    *currentMovable = nav->next[dir][from];
+}
@@ -1,9 +1,26 @@
 #pragma once
 
-#include "game.h"
+#include "common.h"
+#include "engine.h"
 
 typedef uint8_t MovabilityTab[SIZE_Y][SIZE_X];
 
+typedef enum {
+    NavLeft,
+    NavRight,
+    NavUp,
+    NavDown,
+    NavDirectionCount,
+} NavDirection;
+
+#define NAV_FROM_NOWHERE (SIZE_X * SIZE_Y) // slot used when nothing is selected
+
+// Where each arrow key moves selection to, from every cell of the board,
+// worked out once per board state so key presses only look it up
+typedef struct {
+    uint8_t next[NavDirectionCount][SIZE_X * SIZE_Y + 1];
+} NavigationTable;
+
 //-----------------------------------------------------------------------------
 
 uint8_t coord_from(uint8_t x, uint8_t y);
@@ -13,8 +30,6 @@ uint8_t movable_dir(MovabilityTab* mv, uint8_t currentMovable);
 
 //-----------------------------------------------------------------------------
 
-void map_movability(PlayGround* pg, MovabilityTab* mv);
-
 uint8_t find_movable(MovabilityTab* mv);
 uint8_t find_movable_rev(MovabilityTab* mv);
 
@@ -22,3 +37,8 @@ void find_movable_left(MovabilityTab* mv, uint8_t* currentMovable);
 void find_movable_right(MovabilityTab* mv, uint8_t* currentMovable);
 void find_movable_up(MovabilityTab* mv, uint8_t* currentMovable);
 void find_movable_down(MovabilityTab* mv, uint8_t* currentMovable);
+
+//-----------------------------------------------------------------------------
+
+void build_navigation(NavigationTable* nav, MovabilityTab* mv);
+void navigate(NavigationTable* nav, NavDirection dir, uint8_t* currentMovable);
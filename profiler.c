@@ -0,0 +1,306 @@
+#include "profiler.h"
+
+#include <furi_hal.h>
+#include <storage/storage.h>
+#include <toolbox/stream/stream.h>
+#include <toolbox/stream/file_stream.h>
+
+#include "game.h"
+#include "load.h"
+
+_Static_assert(LEVEL_FINISHED + 1 == PROFILER_STATES, "PROFILER_STATES must cover State");
+
+static const char* stateNames[PROFILER_STATES] = {
+    "MAIN_MENU",
+    "INTRO",
+    "RESET_PROMPT",
+    "INVALID_PROMPT",
+    "ABOUT",
+    "SELECT_BRICK",
+    "SELECT_DIRECTION",
+    "SOLUTION_SELECT",
+    "MOVE_SIDES",
+    "MOVE_GRAVITY",
+    "EXPLODE",
+    "PAUSED",
+    "HISTOGRAM",
+    "SOLUTION_PROMPT",
+    "GAME_OVER",
+    "LEVEL_FINISHED",
+};
+
+static const char* metricNames[ProfileMetricCount] = {"draw", "event", "wait"};
+
+//-----------------------------------------------------------------------------
+
+static uint32_t read_cycles() {
+    return furi_hal_cortex_timer_get(0).start;
+}
+
+//-----------------------------------------------------------------------------
+
+void profiler_init(Profiler* p) {
+    memset(p, 0, sizeof(Profiler));
+    p->comboKey = InputKeyMAX;
+
+#if PROFILER_ENABLED
+    p->cyclesPerUs = furi_hal_cortex_instructions_per_microsecond();
+
+    // DWT counter only runs when tracing is enabled, fall back to ticks if not
+    uint32_t before = read_cycles();
+    furi_hal_cortex_delay_us(1);
+    p->useCycles = (read_cycles() != before) && (p->cyclesPerUs > 0);
+    if(!p->useCycles) {
+        FURI_LOG_W(TAG, "DWT not running, profiling with ticks");
+    }
+#endif
+}
+
+//-----------------------------------------------------------------------------
+
+// Odd sequence number marks an update in progress, see profiler_copy
+static void profiler_write_begin(Profiler* p) {
+    __atomic_add_fetch(&p->seq, 1, __ATOMIC_SEQ_CST);
+}
+
+//-----------------------------------------------------------------------------
+
+static void profiler_write_end(Profiler* p) {
+    __atomic_add_fetch(&p->seq, 1, __ATOMIC_SEQ_CST);
+}
+
+//-----------------------------------------------------------------------------
+
+void profiler_copy(Profiler* dst, Profiler* src) {
+    uint32_t seq;
+
+    // copy again if owner thread updated it meanwhile
+    do {
+        while((seq = __atomic_load_n(&src->seq, __ATOMIC_SEQ_CST)) % 2 == 1) {
+            furi_delay_tick(1);
+        }
+        memcpy(dst, src, sizeof(Profiler));
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    } while(__atomic_load_n(&src->seq, __ATOMIC_SEQ_CST) != seq);
+}
+
+//-----------------------------------------------------------------------------
+
+uint32_t profiler_now(Profiler* p) {
+    if(!PROFILER_ENABLED) return 0;
+    return p->useCycles ? read_cycles() : furi_get_tick();
+}
+
+//-----------------------------------------------------------------------------
+
+static uint32_t elapsed_us(Profiler* p, uint32_t since) {
+    uint32_t delta = profiler_now(p) - since;
+    if(p->useCycles) {
+        return delta / p->cyclesPerUs;
+    }
+    return delta * (1000000 / furi_kernel_get_tick_frequency());
+}
+
+//-----------------------------------------------------------------------------
+
+// bucket 0 is below 16us, then two buckets per octave
+static uint8_t bucket_for(uint32_t us) {
+    uint32_t v = us >> 4;
+    if(v == 0) return 0;
+
+    uint8_t lg = 31 - __builtin_clz(v);
+    uint8_t half = (lg > 0) ? ((v >> (lg - 1)) & 1) : 0;
+    return MIN(1 + 2 * lg + half, PROFILER_BUCKETS - 1);
+}
+
+//-----------------------------------------------------------------------------
+
+static uint32_t bucket_limit(uint8_t bucket) {
+    if(bucket == 0) return 16;
+
+    uint8_t lg = (bucket - 1) / 2;
+    if(lg == 0) return 32;
+    return ((bucket - 1) % 2 == 0) ? (24u << lg) : (32u << lg);
+}
+
+//-----------------------------------------------------------------------------
+
+void profiler_record(Profiler* p, uint8_t state, ProfileMetric metric, uint32_t since) {
+    if(!PROFILER_ENABLED || (state >= PROFILER_STATES)) return;
+
+    const uint8_t bucket = bucket_for(elapsed_us(p, since));
+    ProfileHistogram* h = &p->hist[state][metric];
+
+    profiler_write_begin(p);
+    h->buckets[bucket]++;
+    h->count++;
+
+    if(h->count >= PROFILER_WINDOW) {
+        uint8_t i;
+        h->count = 0;
+        for(i = 0; i < PROFILER_BUCKETS; i++) {
+            h->buckets[i] /= 2;
+            h->count += h->buckets[i];
+        }
+    }
+    profiler_write_end(p);
+}
+
+//-----------------------------------------------------------------------------
+
+void profiler_frame(Profiler* p, uint8_t state, uint32_t period) {
+    const uint32_t now = furi_get_tick();
+
+    if(!PROFILER_ENABLED || (state >= PROFILER_STATES)) return;
+
+    profiler_write_begin(p);
+    p->frames[state]++;
+
+    // gap right after timer (re)start is not a drop
+    if((period > 0) && (period == p->lastPeriod) &&
+       ((now - p->lastFrameTick) > (period + period / 2))) {
+        p->drops[state]++;
+    }
+
+    p->lastFrameTick = now;
+    p->lastPeriod = period;
+    profiler_write_end(p);
+}
+
+//-----------------------------------------------------------------------------
+
+uint32_t profiler_percentile(ProfileHistogram* h, uint8_t percent) {
+    uint32_t seen = 0;
+    uint8_t i;
+
+    if(h->count == 0) return 0;
+
+    for(i = 0; i < PROFILER_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if(seen * 100 >= (uint32_t)h->count * percent) {
+            return bucket_limit(i);
+        }
+    }
+    return bucket_limit(PROFILER_BUCKETS - 1);
+}
+
+//-----------------------------------------------------------------------------
+
+ProfilerAction profiler_combo(Profiler* p, InputEvent* event) {
+    const uint32_t now = furi_get_tick();
+    const bool second = (event->key == InputKeyDown) || (event->key == InputKeyRight);
+
+    if(!PROFILER_ENABLED) return ProfilerActionNone;
+
+    if(event->key == p->comboKey) {
+        if(event->type == InputTypeRelease) p->comboKey = InputKeyMAX;
+        return ProfilerActionSwallow;
+    }
+
+    if((event->type == InputTypeLong) && (event->key == InputKeyUp)) {
+        p->comboArmed = true;
+        p->comboTick = now;
+        p->comboKey = event->key;
+        return ProfilerActionSwallow;
+    }
+
+    // second key has to follow soon, anything else in between cancels
+    if(!p->comboArmed) return ProfilerActionNone;
+    if(((now - p->comboTick) > furi_ms_to_ticks(PROFILER_COMBO_MS)) ||
+       (event->type == InputTypeShort) || ((event->type == InputTypePress) && !second)) {
+        p->comboArmed = false;
+        return ProfilerActionNone;
+    }
+    if(!second || (event->type != InputTypeLong)) return ProfilerActionNone;
+
+    p->comboArmed = false;
+    p->comboKey = event->key;
+    return (event->key == InputKeyDown) ? ProfilerActionToggle : ProfilerActionDump;
+}
+
+//-----------------------------------------------------------------------------
+
+bool profiler_dump(Profiler* app, Profiler* draw) {
+    const int bufSize = 160;
+    char buf[bufSize];
+    uint8_t s, m, i;
+    bool saved = false;
+
+    // draw side is taken as a consistent copy, event and wait times added
+    Profiler* p = malloc(sizeof(Profiler));
+    profiler_copy(p, draw);
+    for(s = 0; s < PROFILER_STATES; s++) {
+        p->hist[s][ProfileEvent] = app->hist[s][ProfileEvent];
+        p->hist[s][ProfileWait] = app->hist[s][ProfileWait];
+    }
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(ensure_paths(storage)) {
+        Stream* stream = file_stream_alloc(storage);
+        if(file_stream_open(
+               stream, MY_APP_DATA_PATH("profile.txt"), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            snprintf(
+                buf,
+                bufSize,
+                "# clock %s, times in us, buckets are upper limits\n",
+                p->useCycles ? "dwt" : "tick");
+            stream_write_cstring(stream, buf);
+
+            for(s = 0; s < PROFILER_STATES; s++) {
+                if(p->frames[s] == 0) {
+                    bool any = false;
+                    for(m = 0; m < ProfileMetricCount; m++) {
+                        any |= (p->hist[s][m].count > 0);
+                    }
+                    if(!any) continue;
+                }
+
+                snprintf(
+                    buf,
+                    bufSize,
+                    "%s frames %u drops %u\n",
+                    stateNames[s],
+                    (unsigned int)p->frames[s],
+                    (unsigned int)p->drops[s]);
+                stream_write_cstring(stream, buf);
+
+                for(m = 0; m < ProfileMetricCount; m++) {
+                    ProfileHistogram* h = &p->hist[s][m];
+                    if(h->count == 0) continue;
+
+                    snprintf(
+                        buf,
+                        bufSize,
+                        "  %s n %u p50 %u p99 %u |",
+                        metricNames[m],
+                        h->count,
+                        (unsigned int)profiler_percentile(h, 50),
+                        (unsigned int)profiler_percentile(h, 99));
+                    stream_write_cstring(stream, buf);
+
+                    for(i = 0; i < PROFILER_BUCKETS; i++) {
+                        if(h->buckets[i] == 0) continue;
+                        snprintf(
+                            buf,
+                            bufSize,
+                            " %u:%u",
+                            (unsigned int)bucket_limit(i),
+                            h->buckets[i]);
+                        stream_write_cstring(stream, buf);
+                    }
+                    stream_write_cstring(stream, "\n");
+                }
+            }
+
+            saved = true;
+            file_stream_close(stream);
+        } else {
+            FURI_LOG_E(TAG, "Cannot write profile");
+        }
+        stream_free(stream);
+    }
+    furi_record_close(RECORD_STORAGE);
+    free(p);
+
+    return saved;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <input/input.h>
+
+#include "common.h"
+
+// Frame-time profiler.
+//
+// Draw and event handling times, and how long publishing a render snapshot
+// waited for the one still being drawn, are measured with the DWT cycle
+// counter (or system ticks when it is not running) and kept per game state
+// in small histograms with half-octave buckets. Histograms are halved when
+// they fill up, so they follow recent play rather than the whole session.
+// Long Up followed within a second and a half by long Down toggles the
+// overlay, by long Right writes everything to the SD card. Profiler is only
+// built into debug builds (FURI_DEBUG), release ones neither measure nor
+// react to the combo.
+//
+// Each thread keeps its own Profiler: the app thread times events and
+// snapshot waits, the draw callback times drawing and counts frames. Others
+// read them through the render snapshot or profiler_copy, never directly.
+
+#ifdef FURI_DEBUG
+#define PROFILER_ENABLED 1
+#else
+#define PROFILER_ENABLED 0
+#endif
+
+#define PROFILER_STATES 16 // one per State, checked in profiler.c
+#define PROFILER_COMBO_MS 1500
+#define PROFILER_BUCKETS 24
+#define PROFILER_WINDOW 512
+
+typedef enum {
+    ProfileDraw,
+    ProfileEvent,
+    ProfileWait,
+    ProfileMetricCount,
+} ProfileMetric;
+
+typedef enum {
+    ProfilerActionNone,
+    ProfilerActionToggle,
+    ProfilerActionDump,
+    ProfilerActionSwallow, // combo key, not to be passed to game
+} ProfilerAction;
+
+typedef struct {
+    uint16_t buckets[PROFILER_BUCKETS];
+    uint16_t count;
+} ProfileHistogram;
+
+typedef struct {
+    ProfileHistogram hist[PROFILER_STATES][ProfileMetricCount];
+    uint32_t frames[PROFILER_STATES];
+    uint32_t drops[PROFILER_STATES];
+    bool useCycles;
+    uint32_t cyclesPerUs;
+    uint32_t lastFrameTick;
+    uint32_t lastPeriod;
+    bool comboArmed;
+    uint32_t comboTick;
+    InputKey comboKey; // combo key swallowed until released
+    bool overlay;
+    uint32_t seq; // odd while owner thread updates it
+
+} Profiler;
+
+//-----------------------------------------------------------------------------
+
+void profiler_init(Profiler* p);
+uint32_t profiler_now(Profiler* p);
+void profiler_record(Profiler* p, uint8_t state, ProfileMetric metric, uint32_t since);
+void profiler_frame(Profiler* p, uint8_t state, uint32_t period);
+
+void profiler_copy(Profiler* dst, Profiler* src);
+
+uint32_t profiler_percentile(ProfileHistogram* h, uint8_t percent);
+ProfilerAction profiler_combo(Profiler* p, InputEvent* event);
+bool profiler_dump(Profiler* app, Profiler* draw);
@@ -0,0 +1,158 @@
+#include "recorder.h"
+
+#include <storage/storage.h>
+
+#include "load.h"
+
+// never written to file, tells worker to flush and quit
+#define RECORDER_STOP TelemetryOutcomeCount
+
+//-----------------------------------------------------------------------------
+
+static void recorder_flush(Recorder* r) {
+    TelemetryHeader header;
+    bool written = true;
+    uint8_t i;
+
+    if(r->batchCount == 0) return;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(ensure_paths(storage)) {
+        File* file = storage_file_alloc(storage);
+
+        if(storage_file_open(
+               file, MY_APP_DATA_PATH("telemetry.bin"), FSAM_READ_WRITE, FSOM_OPEN_ALWAYS)) {
+            // new file, or one written by other version, starts over
+            if((storage_file_read(file, &header, sizeof(TelemetryHeader)) !=
+                sizeof(TelemetryHeader)) ||
+               !telemetry_header_valid(&header)) {
+                init_telemetry_header(&header);
+            }
+
+            // stop at first failure, header then keeps counting only older records
+            for(i = 0; (i < r->batchCount) && written; i++) {
+                written =
+                    storage_file_seek(file, telemetry_record_offset(header.written), true) &&
+                    (storage_file_write(file, &r->batch[i], sizeof(TelemetryRecord)) ==
+                     sizeof(TelemetryRecord));
+                if(written) header.written++;
+            }
+
+            written = written && storage_file_seek(file, 0, true) &&
+                      (storage_file_write(file, &header, sizeof(TelemetryHeader)) ==
+                       sizeof(TelemetryHeader));
+            if(!written) {
+                FURI_LOG_E(TAG, "Failed to write telemetry");
+            }
+            storage_file_close(file);
+        } else {
+            FURI_LOG_E(TAG, "Cannot open telemetry file");
+        }
+        storage_file_free(file);
+    }
+    furi_record_close(RECORD_STORAGE);
+
+    r->batchCount = 0;
+}
+
+//-----------------------------------------------------------------------------
+
+static int32_t recorder_worker(void* ctx) {
+    Recorder* r = ctx;
+    TelemetryRecord record;
+    bool running = true;
+    const uint32_t flushDelay = RECORDER_FLUSH_DELAY * furi_kernel_get_tick_frequency() / 1000;
+
+    while(running) {
+        const uint32_t timeout = (r->batchCount > 0) ? flushDelay : FuriWaitForever;
+
+        if(furi_message_queue_get(r->queue, &record, timeout) == FuriStatusOk) {
+            if(record.outcome == RECORDER_STOP) {
+                running = false;
+            } else {
+                r->batch[r->batchCount++] = record;
+                if(r->batchCount < RECORDER_BATCH) continue;
+            }
+        }
+
+        recorder_flush(r);
+    }
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+Recorder* alloc_recorder() {
+    Recorder* r = malloc(sizeof(Recorder));
+
+    r->queue = furi_message_queue_alloc(RECORDER_QUEUE_SIZE, sizeof(TelemetryRecord));
+    r->dropped = 0;
+    r->active = false;
+    r->batchCount = 0;
+    memset(&r->attempt, 0, sizeof(TelemetryRecord));
+
+    r->thread = furi_thread_alloc_ex("VexedRecorder", RECORDER_STACK_SIZE, recorder_worker, r);
+    furi_thread_start(r->thread);
+
+    return r;
+}
+
+//-----------------------------------------------------------------------------
+
+void free_recorder(Recorder* r) {
+    TelemetryRecord stop;
+
+    memset(&stop, 0, sizeof(TelemetryRecord));
+    stop.outcome = RECORDER_STOP;
+
+    // app is closing, waiting for pending records is fine now
+    furi_message_queue_put(r->queue, &stop, FuriWaitForever);
+    furi_thread_join(r->thread);
+    furi_thread_free(r->thread);
+    furi_message_queue_free(r->queue);
+
+    if(r->dropped > 0) {
+        FURI_LOG_W(TAG, "Telemetry records dropped: %u", (unsigned int)r->dropped);
+    }
+    free(r);
+}
+
+//-----------------------------------------------------------------------------
+
+void recorder_begin(Recorder* r, const char* setId, uint8_t level) {
+    memset(&r->attempt, 0, sizeof(TelemetryRecord));
+    r->attempt.setHash = telemetry_set_hash(setId);
+    r->attempt.level = level;
+    r->attempt.startTick = furi_get_tick();
+    r->active = true;
+}
+
+//-----------------------------------------------------------------------------
+
+void recorder_undo(Recorder* r) {
+    if(r->active && (r->attempt.undos < UINT16_MAX)) {
+        r->attempt.undos++;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void recorder_solution_viewed(Recorder* r) {
+    r->attempt.flags |= TELEMETRY_SOLUTION_VIEWED;
+}
+
+//-----------------------------------------------------------------------------
+
+void recorder_end(Recorder* r, uint16_t moves, TelemetryOutcome outcome) {
+    if(!r->active) return;
+
+    r->active = false;
+    r->attempt.endTick = furi_get_tick();
+    r->attempt.moves = moves;
+    r->attempt.outcome = outcome;
+
+    if(furi_message_queue_put(r->queue, &r->attempt, 0) != FuriStatusOk) {
+        r->dropped++;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <furi.h>
+
+#include "common.h"
+#include "telemetry.h"
+
+// Attempt recorder.
+//
+// Game thread only fills in the attempt being played and, once it ends,
+// hands its record over to a queue without waiting. Worker thread collects
+// records and appends them to the telemetry file in batches - when
+// RECORDER_BATCH of them are waiting, RECORDER_FLUSH_DELAY ms after the last
+// one came, and when recorder is freed. Records that do not fit in the queue
+// are dropped rather than holding up the game.
+
+#define RECORDER_QUEUE_SIZE 16
+#define RECORDER_BATCH 8
+#define RECORDER_FLUSH_DELAY 3000
+#define RECORDER_STACK_SIZE 2048
+
+typedef struct {
+    FuriMessageQueue* queue;
+    FuriThread* thread;
+    uint32_t dropped;
+
+    // attempt being played, game thread only
+    TelemetryRecord attempt;
+    bool active;
+
+    // waiting to be written, worker thread only
+    TelemetryRecord batch[RECORDER_BATCH];
+    uint8_t batchCount;
+} Recorder;
+
+//-----------------------------------------------------------------------------
+
+Recorder* alloc_recorder();
+void free_recorder(Recorder* r);
+
+void recorder_begin(Recorder* r, const char* setId, uint8_t level);
+void recorder_undo(Recorder* r);
+void recorder_solution_viewed(Recorder* r);
+void recorder_end(Recorder* r, uint16_t moves, TelemetryOutcome outcome);
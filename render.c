@@ -0,0 +1,166 @@
+#include "render.h"
+
+#include "utils.h"
+
+//-----------------------------------------------------------------------------
+
+Renderer* alloc_renderer() {
+    Renderer* render = malloc(sizeof(Renderer));
+
+    memset(render->snapshots, 0, sizeof(render->snapshots));
+    render->front = RENDER_NONE;
+    render->reading = RENDER_NONE;
+    profiler_init(&render->drawProfile);
+
+    render->boardIcons.valid = false;
+    render->layer.valid = false;
+    render->titleLayout.valid = false;
+    render->descriptionLayout.valid = false;
+
+    return render;
+}
+
+//-----------------------------------------------------------------------------
+
+void free_renderer(Renderer* render) {
+    free_wall_geometry(&render->snapshots[0].walls);
+    free_wall_geometry(&render->snapshots[1].walls);
+    free(render);
+}
+
+//-----------------------------------------------------------------------------
+
+static void copy_text(char* dst, size_t size, FuriString* src) {
+    snprintf(dst, size, "%s", furi_string_get_cstr(src));
+}
+
+//-----------------------------------------------------------------------------
+
+// Revision of text just copied, kept from last published snapshot while the
+// content is the same, so cached layouts of it stay valid
+static uint32_t text_rev(const char* text, const char* lastText, uint32_t lastRev) {
+    if(lastText == NULL) return 1;
+    return (strcmp(text, lastText) == 0) ? lastRev : lastRev + 1;
+}
+
+//-----------------------------------------------------------------------------
+
+static void fill_snapshot(RenderSnapshot* view, RenderSnapshot* last, Game* game) {
+    LevelSet* ls = game->levelSet;
+
+    view->state = game->state;
+    view->gameOverReason = game->gameOverReason;
+    view->framePeriod = frame_period(game);
+    view->profilerOverlay = game->profiler.overlay;
+    if(view->profilerOverlay && (game->state < PROFILER_STATES)) {
+        memcpy(view->profile, game->profiler.hist[game->state], sizeof(view->profile));
+    }
+
+    view->currentLevel = game->currentLevel;
+    view->maxLevel = ls->maxLevel;
+    view->gameMoves = game->gameMoves;
+    view->gamePar = game->levelData->gamePar;
+    view->score = game->score;
+    memcpy(view->parLabel, game->parLabel, PAR_LABEL_SIZE);
+    copy_text(view->levelTitle, RENDER_NAME_SIZE, game->levelData->title);
+    view->levelTitleRev = text_rev(
+        view->levelTitle, last ? last->levelTitle : NULL, last ? last->levelTitleRev : 0);
+
+    view->layerRev = game->layerRev;
+    view->levelRev = game->levelRev;
+    copy_level(view->board, game->board);
+    if(view->wallsRev != game->levelRev) {
+        copy_wall_geometry(&view->walls, &game->walls);
+        view->wallsRev = game->levelRev;
+    }
+    copy_level(view->toAnimate, game->toAnimate);
+    view->animatedCount = game->animatedCount;
+    memcpy(view->animatedCells, game->animatedCells, game->animatedCount);
+    copy_level(view->movables, game->movables);
+    view->currentMovable = game->currentMovable;
+    view->canUndo = history_can_undo(&game->history);
+    view->canRedo = history_can_redo(&game->history);
+    view->canSolve = game->levelData->solutionSteps.valid;
+    view->move = game->move;
+    view->flashSteps = game->flashSteps;
+
+    view->solutionMode = game->solutionMode;
+    view->solutionStep = game->solutionStep;
+    view->solutionTotal = game->solutionTotal;
+    view->solutionPaused = game->solutionPaused;
+    view->solutionSpeed = game->solutionSpeed;
+    view->solutionPenalty = (game->state == SOLUTION_PROMPT) && solution_will_have_penalty(game);
+
+    copy_text(view->bricksNonZero, sizeof(view->bricksNonZero), game->stats->bricksNonZero);
+    memcpy(view->statsNonZero, game->stats->statsNonZero, sizeof(view->statsNonZero));
+
+    view->menuPausedPos = game->menuPausedPos;
+    view->turbo = game->settings.turbo;
+    view->mainMenuBtn = game->mainMenuBtn;
+    view->mainMenuMode = game->mainMenuMode;
+    view->mainMenuInfo = game->mainMenuInfo;
+    view->hasContinue = game->hasContinue;
+    view->selectedLevel = game->selectedLevel;
+    view->selectedMoves = ls->scores[game->selectedLevel].moves;
+    view->selectedPar = ls->pars[game->selectedLevel];
+    score_for_level(game, game->selectedLevel, view->selectedScore, PAR_LABEL_SIZE);
+    copy_text(view->selectedSet, RENDER_NAME_SIZE, game->selectedSet);
+    view->continueLevel = game->continueLevel;
+    copy_text(view->continueSet, RENDER_NAME_SIZE, game->continueSet);
+    view->setPos = game->setPos;
+    view->setCount = game->setCount;
+    copy_text(view->setTitle, RENDER_NAME_SIZE, ls->title);
+    copy_text(view->setAuthor, RENDER_NAME_SIZE, ls->author);
+    copy_text(view->setUrl, RENDER_NAME_SIZE, ls->url);
+    copy_text(view->setDescription, RENDER_TEXT_SIZE, ls->description);
+    view->setDescriptionRev = text_rev(
+        view->setDescription,
+        last ? last->setDescription : NULL,
+        last ? last->setDescriptionRev : 0);
+
+    copy_text(view->errorMsg, RENDER_TEXT_SIZE, game->errorMsg);
+    memcpy(view->bg, game->bg, sizeof(BackGround));
+    view->bgShiftX = game->bgShiftX;
+    view->bgShiftY = game->bgShiftY;
+}
+
+//-----------------------------------------------------------------------------
+
+void publish_snapshot(Renderer* render, Game* game) {
+    const uint8_t front = __atomic_load_n(&render->front, __ATOMIC_SEQ_CST);
+    const uint8_t back = (front == 0) ? 1 : 0;
+    const uint32_t waitStart = profiler_now(&game->profiler);
+
+    // previous snapshot may still be drawn after two quick publishes
+    while(__atomic_load_n(&render->reading, __ATOMIC_SEQ_CST) == back) {
+        furi_delay_tick(1);
+    }
+    profiler_record(&game->profiler, game->state, ProfileWait, waitStart);
+
+    // front snapshot is never written, reading it here is safe
+    fill_snapshot(
+        &render->snapshots[back], (front == RENDER_NONE) ? NULL : &render->snapshots[front], game);
+    __atomic_store_n(&render->front, back, __ATOMIC_SEQ_CST);
+}
+
+//-----------------------------------------------------------------------------
+
+RenderSnapshot* acquire_snapshot(Renderer* render) {
+    uint8_t front;
+
+    // claim front, then make sure it was not swapped meanwhile - writer
+    // never fills the front snapshot, so once claimed it stays intact
+    do {
+        front = __atomic_load_n(&render->front, __ATOMIC_SEQ_CST);
+        if(front == RENDER_NONE) return NULL;
+        __atomic_store_n(&render->reading, front, __ATOMIC_SEQ_CST);
+    } while(__atomic_load_n(&render->front, __ATOMIC_SEQ_CST) != front);
+
+    return &render->snapshots[front];
+}
+
+//-----------------------------------------------------------------------------
+
+void release_snapshot(Renderer* render) {
+    __atomic_store_n(&render->reading, RENDER_NONE, __ATOMIC_SEQ_CST);
+}
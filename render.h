@@ -0,0 +1,149 @@
+#pragma once
+
+#include "game.h"
+#include "walls.h"
+#include "ui.h"
+
+// Render snapshots.
+//
+// Game logic runs on the app thread, drawing on the GUI thread. Instead of
+// sharing Game under a mutex, the app thread copies everything drawing
+// needs into one of two snapshots after handling events and publishes it
+// by swapping an index. Draw callback reads the last published snapshot
+// without locking; writer only waits when it would overwrite the snapshot
+// still being drawn, which needs two publishes within a single frame.
+
+#define RENDER_NAME_SIZE 48
+#define RENDER_TEXT_SIZE 160
+#define RENDER_NONE 0xFF
+
+// Everything besides the board that the static layer depends on
+typedef struct {
+    uint32_t rev;
+    State state;
+    bool showScore;
+    bool hintBoth;
+    uint8_t solutionStep;
+    bool solutionPaused;
+    uint8_t solutionSpeed;
+    unsigned int gameMoves;
+    int16_t score;
+} LayerKey;
+
+#define LAYER_BUFFER_SIZE (128 * 64 / 8)
+
+// Icon of every board cell, NULL for empty ones, rebuilt after board change
+typedef struct {
+    uint32_t rev;
+    bool gameOver;
+    bool valid;
+    const Icon* icons[SIZE_Y][SIZE_X];
+} BoardIcons;
+
+// Playfield, score panel and hint as drawn after the last board change,
+// copied over the frame in one go instead of being redrawn
+typedef struct {
+    LayerKey key;
+    bool valid;
+    uint8_t buffer[LAYER_BUFFER_SIZE];
+} StaticLayer;
+
+// Copy of game state as seen by drawing, strings included
+typedef struct {
+    State state;
+    GameOver gameOverReason;
+    uint32_t framePeriod;
+    bool profilerOverlay;
+    ProfileHistogram profile[ProfileMetricCount]; // app side, of state drawn
+
+    // score
+    uint8_t currentLevel;
+    uint8_t maxLevel;
+    unsigned int gameMoves;
+    unsigned int gamePar;
+    int16_t score;
+    char parLabel[PAR_LABEL_SIZE];
+    char levelTitle[RENDER_NAME_SIZE];
+    uint32_t levelTitleRev; // changes with levelTitle content
+
+    // board
+    uint32_t layerRev;
+    uint32_t levelRev;
+    PlayGround board;
+    WallGeometry walls; // copied from game once per level
+    uint32_t wallsRev;
+    PlayGround toAnimate;
+    uint8_t animatedCells[SIZE_X * SIZE_Y];
+    uint8_t animatedCount;
+    PlayGround movables;
+    uint8_t currentMovable;
+    bool canUndo;
+    bool canRedo;
+    bool canSolve;
+    MoveInfo move;
+    uint8_t flashSteps;
+
+    // solution
+    bool solutionMode;
+    uint8_t solutionStep;
+    uint8_t solutionTotal;
+    bool solutionPaused;
+    uint8_t solutionSpeed;
+    bool solutionPenalty;
+
+    // board stats
+    char bricksNonZero[WALL_TILE + 1];
+    uint8_t statsNonZero[WALL_TILE + 1];
+
+    // menus
+    uint8_t menuPausedPos;
+    bool turbo;
+    MenuButtons mainMenuBtn;
+    GameMode mainMenuMode;
+    bool mainMenuInfo;
+    bool hasContinue;
+    uint8_t selectedLevel;
+    uint16_t selectedMoves;
+    uint8_t selectedPar;
+    char selectedScore[PAR_LABEL_SIZE];
+    char selectedSet[RENDER_NAME_SIZE];
+    uint8_t continueLevel;
+    char continueSet[RENDER_NAME_SIZE];
+    uint8_t setPos;
+    uint8_t setCount;
+    char setTitle[RENDER_NAME_SIZE];
+    char setAuthor[RENDER_NAME_SIZE];
+    char setUrl[RENDER_NAME_SIZE];
+    char setDescription[RENDER_TEXT_SIZE];
+    uint32_t setDescriptionRev; // changes with setDescription content
+
+    char errorMsg[RENDER_TEXT_SIZE];
+    BackGround bg;
+    uint8_t bgShiftX;
+    uint8_t bgShiftY;
+} RenderSnapshot;
+
+typedef struct {
+    RenderSnapshot snapshots[2];
+    uint8_t front; // last published snapshot, RENDER_NONE before first one
+    uint8_t reading; // snapshot being drawn, RENDER_NONE when idle
+
+    Profiler drawProfile; // written by draw callback only
+
+    // derived from snapshots, touched by draw callback only
+    BoardIcons boardIcons;
+    StaticLayer layer;
+    TextLayout titleLayout;
+    TextLayout descriptionLayout;
+} Renderer;
+
+//-----------------------------------------------------------------------------
+
+Renderer* alloc_renderer();
+void free_renderer(Renderer* render);
+
+//-----------------------------------------------------------------------------
+
+void publish_snapshot(Renderer* render, Game* game);
+RenderSnapshot* acquire_snapshot(Renderer* render);
+void release_snapshot(Renderer* render);
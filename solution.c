@@ -0,0 +1,179 @@
+#include "solution.h"
+
+#include "engine.h"
+#include "move.h"
+
+//-----------------------------------------------------------------------------
+
+static bool decode_solution_step(
+    const char* solution,
+    uint8_t step,
+    uint8_t* x,
+    uint8_t* y,
+    uint8_t* dir) {
+    const char solX = solution[step * 2];
+    const char solY = solution[step * 2 + 1];
+    int cx, cy;
+
+    // move direction is marked by which of the two letters is uppercase
+    *dir = MOVABLE_NOT;
+    cx = solX - 'a';
+    if(solX <= 'Z') {
+        *dir = MOVABLE_LEFT;
+        cx = solX - 'A';
+    }
+    cy = solY - 'a';
+    if(solY <= 'Z') {
+        *dir = MOVABLE_RIGHT;
+        cy = solY - 'A';
+    }
+
+    if(cx < 0 || cx >= SIZE_X || cy < 0 || cy >= SIZE_Y || *dir == MOVABLE_NOT) {
+        return false;
+    }
+
+    *x = cx;
+    *y = cy;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+static bool solution_step_valid(PlayGround* pg, uint8_t x, uint8_t y, uint8_t dir) {
+    if(!is_block((*pg)[y][x])) return false;
+
+    if(dir == MOVABLE_LEFT) return (x > 0) && ((*pg)[y][x - 1] == EMPTY_TILE);
+    return (x < SIZE_X - 1) && ((*pg)[y][x + 1] == EMPTY_TILE);
+}
+
+//-----------------------------------------------------------------------------
+
+static uint16_t
+    solution_diff(PlayGround* before, PlayGround* after, uint16_t* changes, uint16_t count) {
+    uint8_t x, y;
+
+    for(y = 0; y < SIZE_Y; y++) {
+        for(x = 0; x < SIZE_X; x++) {
+            if((*before)[y][x] != (*after)[y][x]) {
+                if(changes != NULL) {
+                    changes[count] = SOLUTION_CHANGE(y * SIZE_X + x, (*after)[y][x]);
+                }
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+
+static uint16_t solution_replay(
+    PlayGround* start,
+    SolutionSteps* solution,
+    uint16_t* changes,
+    uint16_t* stepStart,
+    uint8_t* steps) {
+    PlayGround board, next;
+    uint8_t step, x, y, dir;
+    uint16_t count = 0;
+
+    memcpy(board, start, sizeof(PlayGround));
+    for(step = 0; step < solution->count; step++) {
+        if(stepStart != NULL) stepStart[step] = count;
+
+        x = coord_x(solution->steps[step].coord);
+        y = coord_y(solution->steps[step].coord);
+        dir = solution->steps[step].dir;
+        if(board[y][x] == EMPTY_TILE) continue; // some stored solutions have idle steps
+        if(!solution_step_valid(&board, x, y, dir)) break;
+
+        memcpy(next, board, sizeof(PlayGround));
+        apply_move(&next, x, y, dir);
+        count = solution_diff(&board, &next, changes, count);
+        memcpy(board, next, sizeof(PlayGround));
+    }
+    if(stepStart != NULL) stepStart[step] = count;
+
+    *steps = step;
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+
+bool decode_solution(const char* solution, PlayGround* start, SolutionSteps* decoded) {
+    const size_t length = strlen(solution);
+    uint8_t step, x, y, dir, replayed;
+
+    decoded->count = 0;
+    decoded->valid = false;
+
+    if((length % 2 != 0) || (length / 2 > SOLUTION_MAX_STEPS)) {
+        FURI_LOG_E(TAG, "Solution has invalid length %u", (unsigned int)length);
+        return false;
+    }
+
+    for(step = 0; step < length / 2; step++) {
+        if(!decode_solution_step(solution, step, &x, &y, &dir)) {
+            FURI_LOG_E(TAG, "Solution cannot be decoded at step %u", step + 1);
+            return false;
+        }
+        decoded->steps[step].coord = coord_from(x, y);
+        decoded->steps[step].dir = dir;
+    }
+    decoded->count = step;
+
+    // every move must be legal on the board left by previous ones
+    solution_replay(start, decoded, NULL, NULL, &replayed);
+    if(replayed < decoded->count) {
+        FURI_LOG_E(TAG, "Solution invalid at step %u of %u", replayed + 1, decoded->count);
+        return false;
+    }
+
+    decoded->valid = true;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+void init_solution_track(SolutionTrack* track) {
+    memset(track, 0, sizeof(SolutionTrack));
+}
+
+//-----------------------------------------------------------------------------
+
+uint8_t build_solution_track(SolutionTrack* track, PlayGround* start, SolutionSteps* solution) {
+    free_solution_track(track);
+    memcpy(track->start, start, sizeof(PlayGround));
+
+    // first pass only counts changes, second one fills exactly sized arrays
+    const uint16_t changeCount =
+        solution_replay(start, solution, NULL, NULL, &track->stepCount);
+    track->changes = malloc(sizeof(uint16_t) * MAX(changeCount, 1));
+    track->stepStart = malloc(sizeof(uint16_t) * (solution->count + 1));
+    solution_replay(start, solution, track->changes, track->stepStart, &track->stepCount);
+
+    return track->stepCount;
+}
+
+//-----------------------------------------------------------------------------
+
+void solution_board_at(SolutionTrack* track, uint8_t step, PlayGround* pg) {
+    uint16_t i;
+    uint8_t* cells = &(*pg)[0][0];
+
+    memcpy(pg, track->start, sizeof(PlayGround));
+    if(track->stepStart == NULL) return;
+
+    step = MIN(step, track->stepCount);
+    for(i = 0; i < track->stepStart[step]; i++) {
+        cells[SOLUTION_CHANGE_CELL(track->changes[i])] = SOLUTION_CHANGE_TILE(track->changes[i]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void free_solution_track(SolutionTrack* track) {
+    free(track->changes);
+    free(track->stepStart);
+    init_solution_track(track);
+}
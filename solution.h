@@ -0,0 +1,47 @@
+#pragma once
+
+#include "common.h"
+
+// Stored solutions.
+//
+// Solution of a level is decoded from its two-letter notation and replayed
+// on the initial board once, when the level is loaded. Broken ones are
+// rejected there, so playback only indexes steps known to be legal.
+//
+// Solution trajectory is computed when playback of a level starts first
+// time. Only the starting board is kept in full. Every step stores the cells its
+// whole cascade changed, so the settled board after any step is rebuilt by
+// replaying changes from the start - cheap enough to seek on every keypress.
+
+#define SOLUTION_CHANGE(cell, tile) ((uint16_t)((cell) | ((tile) << 8)))
+#define SOLUTION_CHANGE_CELL(change) ((change) & 0xFF)
+#define SOLUTION_CHANGE_TILE(change) ((change) >> 8)
+
+#define SOLUTION_MAX_STEPS 255
+
+typedef struct {
+    uint8_t coord; // see coord_from
+    uint8_t dir; // MOVABLE_LEFT or MOVABLE_RIGHT
+} SolutionStep;
+
+typedef struct {
+    SolutionStep steps[SOLUTION_MAX_STEPS];
+    uint8_t count;
+    bool valid;
+} SolutionSteps;
+
+typedef struct {
+    PlayGround start;
+    uint16_t* changes; // cell index and new tile, see SOLUTION_CHANGE
+    uint16_t* stepStart; // first change of each step, stepCount + 1 entries
+    uint8_t stepCount;
+} SolutionTrack;
+
+//-----------------------------------------------------------------------------
+
+bool decode_solution(const char* solution, PlayGround* start, SolutionSteps* decoded);
+
+void init_solution_track(SolutionTrack* track);
+uint8_t build_solution_track(SolutionTrack* track, PlayGround* start, SolutionSteps* solution);
+void solution_board_at(SolutionTrack* track, uint8_t step, PlayGround* pg);
+void free_solution_track(SolutionTrack* track);
@@ -13,19 +13,11 @@ void free_stats(Stats* stats) {
 }
 
 void update_board_stats(PlayGround* pg, Stats* stats) {
-    memset(stats->ofBrick, '\0', sizeof(stats->ofBrick));
     char buff[2];
     memset(buff, '\0', sizeof(buff));
 
-    uint8_t x, y, i, tile;
-    for(y = 0; y < SIZE_Y; y++) {
-        for(x = 0; x < SIZE_X; x++) {
-            tile = (*pg)[y][x];
-            if(is_block(tile)) {
-                stats->ofBrick[tile]++;
-            }
-        }
-    }
+    uint8_t i;
+    count_bricks(pg, stats->ofBrick);
 
     memset(stats->statsNonZero, 0, sizeof(stats->statsNonZero));
     furi_string_reset(stats->bricksNonZero);
@@ -0,0 +1,37 @@
+#include "telemetry.h"
+
+//-----------------------------------------------------------------------------
+
+uint32_t telemetry_set_hash(const char* setId) {
+    // 32-bit FNV-1a
+    uint32_t hash = 2166136261u;
+    while(*setId) {
+        hash ^= (uint8_t)*setId++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+
+void init_telemetry_header(TelemetryHeader* header) {
+    header->magic = TELEMETRY_MAGIC;
+    header->version = TELEMETRY_VERSION;
+    header->recordSize = sizeof(TelemetryRecord);
+    header->capacity = TELEMETRY_CAPACITY;
+    header->written = 0;
+}
+
+//-----------------------------------------------------------------------------
+
+bool telemetry_header_valid(TelemetryHeader* header) {
+    return (header->magic == TELEMETRY_MAGIC) && (header->version == TELEMETRY_VERSION) &&
+           (header->recordSize == sizeof(TelemetryRecord)) &&
+           (header->capacity == TELEMETRY_CAPACITY);
+}
+
+//-----------------------------------------------------------------------------
+
+uint32_t telemetry_record_offset(uint32_t index) {
+    return sizeof(TelemetryHeader) + (index % TELEMETRY_CAPACITY) * sizeof(TelemetryRecord);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "common.h"
+
+// Play telemetry file format.
+//
+// Every attempt of a level - from its start until it is finished, lost and
+// left, restarted or abandoned - ends up as one fixed-size record. Records
+// live in a ring of TELEMETRY_CAPACITY slots after the header, so the file
+// never grows past a few KiB and keeps the most recent attempts. Header
+// counts all records ever written; next one goes to slot written % capacity.
+// Everything is little endian, as written by Flipper. This module does not
+// depend on firmware, so host tools read the file with the same structures.
+
+#define TELEMETRY_MAGIC 0x4C545856 // "VXTL"
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_CAPACITY 512
+
+#define TELEMETRY_SOLUTION_VIEWED 0x01
+
+// values below TELEMETRY_FINISHED match GameOver reasons
+typedef enum {
+    TelemetryAbandoned = 0,
+    TelemetryCannotMove = 1,
+    TelemetryBricksLeft = 2,
+    TelemetryFinished = 3,
+    TelemetryOutcomeCount,
+} TelemetryOutcome;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t capacity;
+    uint32_t written;
+} TelemetryHeader;
+
+typedef struct {
+    uint32_t setHash; // see telemetry_set_hash
+    uint32_t startTick;
+    uint32_t endTick;
+    uint16_t moves;
+    uint16_t undos;
+    uint8_t level;
+    uint8_t outcome;
+    uint8_t flags;
+    uint8_t reserved;
+} TelemetryRecord;
+
+//-----------------------------------------------------------------------------
+
+uint32_t telemetry_set_hash(const char* setId);
+void init_telemetry_header(TelemetryHeader* header);
+bool telemetry_header_valid(TelemetryHeader* header);
+uint32_t telemetry_record_offset(uint32_t index);
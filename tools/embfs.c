@@ -0,0 +1,520 @@
+#include "embfs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "codec.h"
+#include "engine.h"
+
+#define EMBFS_MIN_FILE_BUFFER 4096
+#define EMBFS_MAX_FAN_IN 64
+
+typedef enum {
+    EXPAND_DONE,
+    EXPAND_GOAL,
+    EXPAND_FAILED,
+} ExpandResult;
+
+typedef struct {
+    StateCodec codec;
+    size_t keySize;
+    char dir[256];
+    size_t memoryCap;
+
+    uint8_t* buffer;
+    size_t bufferCount;
+    size_t bufferCapacity;
+    int runCount;
+
+    int layerCount;
+    size_t states;
+} Embfs;
+
+typedef struct {
+    bool layer; // earlier layer, run otherwise
+    int index;
+} EmbfsSource;
+
+typedef struct {
+    FILE* file;
+    char* fileBuffer;
+    uint8_t key[STATE_KEY_MAX];
+    bool valid;
+    bool failed;
+    bool earlier;
+} EmbfsCursor;
+
+//-----------------------------------------------------------------------------
+
+static void layer_path(Embfs* e, int layer, char* path, size_t size) {
+    snprintf(path, size, "%s/layer-%03d", e->dir, layer);
+}
+
+//-----------------------------------------------------------------------------
+
+static void run_path(Embfs* e, int run, char* path, size_t size) {
+    snprintf(path, size, "%s/run-%04d", e->dir, run);
+}
+
+//-----------------------------------------------------------------------------
+
+static void source_path(Embfs* e, EmbfsSource* source, char* path, size_t size) {
+    if(source->layer) {
+        layer_path(e, source->index, path, size);
+    } else {
+        run_path(e, source->index, path, size);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+static size_t sort_key_size;
+
+static int compare_keys(const void* a, const void* b) {
+    return memcmp(a, b, sort_key_size);
+}
+
+//-----------------------------------------------------------------------------
+
+// Sorts the successor buffer into a new run file. False when it cannot be
+// written whole; buffer is kept then and the search has to stop.
+static bool spill_run(Embfs* e) {
+    char path[300];
+    const size_t k = e->keySize;
+    size_t i, unique = 0;
+    bool ok = true;
+
+    if(e->bufferCount == 0) return true;
+
+    sort_key_size = k;
+    qsort(e->buffer, e->bufferCount, k, compare_keys);
+
+    run_path(e, e->runCount, path, sizeof(path));
+    FILE* f = fopen(path, "wb");
+    if(f == NULL) return false;
+
+    for(i = 0; (i < e->bufferCount) && ok; i++) {
+        if((unique > 0) && (memcmp(&e->buffer[i * k], &e->buffer[(i - 1) * k], k) == 0)) {
+            continue;
+        }
+        ok = (fwrite(&e->buffer[i * k], 1, k, f) == k);
+        unique++;
+    }
+
+    ok &= (fclose(f) == 0);
+    if(!ok) {
+        unlink(path);
+        return false;
+    }
+
+    e->runCount++;
+    e->bufferCount = 0;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+static bool cursor_open(EmbfsCursor* c, const char* path, size_t bufferSize, bool earlier) {
+    memset(c, 0, sizeof(EmbfsCursor));
+    c->earlier = earlier;
+    c->file = fopen(path, "rb");
+    if(c->file == NULL) return false;
+    c->fileBuffer = malloc(bufferSize);
+    if(c->fileBuffer != NULL) {
+        setvbuf(c->file, c->fileBuffer, _IOFBF, bufferSize);
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+static void cursor_next(EmbfsCursor* c, size_t keySize) {
+    c->valid = (fread(c->key, 1, keySize, c->file) == keySize);
+    if(!c->valid && ferror(c->file)) c->failed = true;
+}
+
+//-----------------------------------------------------------------------------
+
+static void cursor_close(EmbfsCursor* c) {
+    if(c->file != NULL) fclose(c->file);
+    free(c->fileBuffer);
+    c->file = NULL;
+    c->fileBuffer = NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+// Min-heap of cursor indices ordered by their current key
+static void heap_sift_down(EmbfsCursor* cursors, int* heap, int count, int pos, size_t k) {
+    int child, swap;
+
+    while((child = pos * 2 + 1) < count) {
+        if((child + 1 < count) &&
+           (memcmp(cursors[heap[child + 1]].key, cursors[heap[child]].key, k) < 0)) {
+            child++;
+        }
+        if(memcmp(cursors[heap[child]].key, cursors[heap[pos]].key, k) >= 0) break;
+
+        swap = heap[pos];
+        heap[pos] = heap[child];
+        heap[child] = swap;
+        pos = child;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+// How many files a single merge pass reads, so that their buffers together
+// with the output one stay within memoryCap
+static int merge_fan_in(Embfs* e) {
+    const size_t files = e->memoryCap / EMBFS_MIN_FILE_BUFFER;
+
+    if(files < 3) return 2;
+    return (int)MIN(files - 1, (size_t)EMBFS_MAX_FAN_IN);
+}
+
+//-----------------------------------------------------------------------------
+
+// Merges sorted source files into one: every key of a run once, unless it is
+// found in one of the layers merged with it. Returns number of keys written,
+// or -1 on I/O error.
+static long merge_files(Embfs* e, EmbfsSource* sources, int count, const char* outPath) {
+    const size_t k = e->keySize;
+    const size_t bufferSize =
+        MAX(e->memoryCap / (merge_fan_in(e) + 1), (size_t)EMBFS_MIN_FILE_BUFFER);
+    EmbfsCursor cursors[EMBFS_MAX_FAN_IN];
+    int heap[EMBFS_MAX_FAN_IN];
+    uint8_t key[STATE_KEY_MAX];
+    char path[300];
+    char* outBuffer = NULL;
+    FILE* out = NULL;
+    long written = 0;
+    int i, heapCount = 0;
+    bool seen;
+
+    memset(cursors, 0, sizeof(cursors));
+    for(i = 0; i < count; i++) {
+        source_path(e, &sources[i], path, sizeof(path));
+        if(!cursor_open(&cursors[i], path, bufferSize, sources[i].layer)) {
+            written = -1;
+            goto done;
+        }
+        cursor_next(&cursors[i], k);
+        if(cursors[i].valid) heap[heapCount++] = i;
+    }
+    for(i = heapCount / 2 - 1; i >= 0; i--) {
+        heap_sift_down(cursors, heap, heapCount, i, k);
+    }
+
+    out = fopen(outPath, "wb");
+    if(out == NULL) {
+        written = -1;
+        goto done;
+    }
+    outBuffer = malloc(bufferSize);
+    if(outBuffer != NULL) {
+        setvbuf(out, outBuffer, _IOFBF, bufferSize);
+    }
+
+    while(heapCount > 0) {
+        memcpy(key, cursors[heap[0]].key, k);
+        seen = false;
+        while((heapCount > 0) && (memcmp(cursors[heap[0]].key, key, k) == 0)) {
+            EmbfsCursor* c = &cursors[heap[0]];
+            seen |= c->earlier;
+            cursor_next(c, k);
+            if(!c->valid) heap[0] = heap[--heapCount];
+            heap_sift_down(cursors, heap, heapCount, 0, k);
+        }
+
+        if(!seen) {
+            if(fwrite(key, 1, k, out) != k) {
+                written = -1;
+                goto done;
+            }
+            written++;
+        }
+    }
+
+done:
+    for(i = 0; i < count; i++) {
+        if(cursors[i].failed) written = -1;
+        cursor_close(&cursors[i]);
+    }
+    if((out != NULL) && (fclose(out) != 0)) written = -1;
+    free(outBuffer);
+    return written;
+}
+
+//-----------------------------------------------------------------------------
+
+// Merges the spilled runs into the next layer file, dropping keys already in
+// any earlier layer. Runs are merged into one first and earlier layers are
+// then subtracted from it, in passes reading at most merge_fan_in files, so
+// neither memory nor open files grow with the number of runs or layers.
+// Returns number of new states, or -1 on I/O error.
+static long merge_layer(Embfs* e) {
+    const int fanIn = merge_fan_in(e);
+    EmbfsSource sources[EMBFS_MAX_FAN_IN];
+    char path[300];
+    long written = 0;
+    int first = 0, layer = 0, count, i;
+    bool last;
+
+    if(e->runCount == 0) return 0;
+
+    while((e->runCount - first) > 1) {
+        count = MIN(fanIn, e->runCount - first);
+        for(i = 0; i < count; i++) {
+            sources[i].layer = false;
+            sources[i].index = first + i;
+        }
+
+        run_path(e, e->runCount, path, sizeof(path));
+        e->runCount++;
+        if(merge_files(e, sources, count, path) < 0) return -1;
+
+        for(i = 0; i < count; i++) {
+            run_path(e, first + i, path, sizeof(path));
+            unlink(path);
+        }
+        first += count;
+    }
+
+    do {
+        sources[0].layer = false;
+        sources[0].index = first;
+        for(count = 1; (count < fanIn) && (layer < e->layerCount); count++) {
+            sources[count].layer = true;
+            sources[count].index = layer++;
+        }
+
+        last = (layer == e->layerCount);
+        if(last) {
+            layer_path(e, e->layerCount, path, sizeof(path));
+        } else {
+            run_path(e, e->runCount, path, sizeof(path));
+            e->runCount++;
+        }
+        written = merge_files(e, sources, count, path);
+        if(written < 0) return -1;
+
+        run_path(e, first, path, sizeof(path));
+        unlink(path);
+        first = e->runCount - 1;
+    } while(!last);
+
+    e->layerCount++;
+    e->runCount = 0;
+    return written;
+}
+
+//-----------------------------------------------------------------------------
+
+// Finds a state of the given layer with a move leading to `target`, and turns
+// `target` into that state.
+static bool trace_parent(Embfs* e, int layer, uint8_t* target, uint8_t* move) {
+    PlayGround board, next;
+    MoveList moves;
+    uint8_t key[STATE_KEY_MAX], succ[STATE_KEY_MAX];
+    uint8_t x, y, dir, m;
+    char path[300];
+    bool found = false;
+
+    layer_path(e, layer, path, sizeof(path));
+    FILE* f = fopen(path, "rb");
+    if(f == NULL) return false;
+
+    while(!found && (fread(key, 1, e->keySize, f) == e->keySize)) {
+        decode_state(&e->codec, key, &board);
+        generate_moves(&board, &moves);
+        for(m = 0; m < moves.count && !found; m++) {
+            x = BOARD_COORD_X(moves.moves[m].coord);
+            y = BOARD_COORD_Y(moves.moves[m].coord);
+            dir = moves.moves[m].dir;
+
+            memcpy(next, board, sizeof(PlayGround));
+            apply_move(&next, x, y, dir);
+            encode_state(&e->codec, &next, succ);
+            if(memcmp(succ, target, e->keySize) == 0) {
+                memcpy(target, key, e->keySize);
+                *move = SEARCH_MOVE(x, y, dir);
+                found = true;
+            }
+        }
+    }
+
+    fclose(f);
+    return found;
+}
+
+//-----------------------------------------------------------------------------
+
+// Expands one layer into spilled runs. On EXPAND_GOAL a move clears the board;
+// `goal` then holds the state it was made from and `goalMove` the move.
+static ExpandResult expand_layer(
+    Embfs* e,
+    SearchStats* stats,
+    uint8_t* goal,
+    uint8_t* goalMove) {
+    PlayGround board, next;
+    MoveList moves;
+    uint8_t key[STATE_KEY_MAX];
+    uint8_t x, y, dir, m;
+    char path[300];
+
+    layer_path(e, e->layerCount - 1, path, sizeof(path));
+    FILE* f = fopen(path, "rb");
+    if(f == NULL) return EXPAND_FAILED;
+
+    while(fread(key, 1, e->keySize, f) == e->keySize) {
+        decode_state(&e->codec, key, &board);
+        stats->expanded++;
+
+        generate_moves(&board, &moves);
+        for(m = 0; m < moves.count; m++) {
+            x = BOARD_COORD_X(moves.moves[m].coord);
+            y = BOARD_COORD_Y(moves.moves[m].coord);
+            dir = moves.moves[m].dir;
+
+            memcpy(next, board, sizeof(PlayGround));
+            apply_move(&next, x, y, dir);
+            if(board_is_dead(&next)) continue;
+
+            if(board_is_clear(&next)) {
+                memcpy(goal, key, e->keySize);
+                *goalMove = SEARCH_MOVE(x, y, dir);
+                fclose(f);
+                return EXPAND_GOAL;
+            }
+
+            if((e->bufferCount == e->bufferCapacity) && !spill_run(e)) {
+                fclose(f);
+                return EXPAND_FAILED;
+            }
+            encode_state(&e->codec, &next, &e->buffer[e->bufferCount * e->keySize]);
+            e->bufferCount++;
+        }
+    }
+
+    const bool failed = ferror(f);
+    fclose(f);
+    if(failed || !spill_run(e)) return EXPAND_FAILED;
+    return EXPAND_DONE;
+}
+
+//-----------------------------------------------------------------------------
+
+void solve_level_external(
+    PlayGround* start,
+    const char* tempDir,
+    size_t memoryCap,
+    size_t maxStates,
+    SearchStats* stats) {
+    Embfs e;
+    uint8_t goal[STATE_KEY_MAX];
+    uint8_t path[SEARCH_MAX_DEPTH];
+    char file[300];
+    uint8_t goalMove;
+    ExpandResult expanded;
+    bool written;
+    int len, i;
+
+    memset(stats, 0, sizeof(SearchStats));
+    if(board_is_clear(start)) {
+        stats->result = SEARCH_SOLVED;
+        return;
+    }
+
+    memset(&e, 0, sizeof(Embfs));
+    state_codec_init(&e.codec, start);
+    e.keySize = e.codec.keySize;
+    e.memoryCap = memoryCap;
+    snprintf(e.dir, sizeof(e.dir), "%s/vexed-XXXXXX", tempDir);
+    if(mkdtemp(e.dir) == NULL) {
+        stats->result = SEARCH_ERROR;
+        return;
+    }
+
+    // the successor buffer takes the whole budget while a layer is expanded
+    e.bufferCapacity = MAX(memoryCap / e.keySize, 1);
+    e.buffer = malloc(e.bufferCapacity * e.keySize);
+
+    layer_path(&e, 0, file, sizeof(file));
+    FILE* f = fopen(file, "wb");
+    encode_state(&e.codec, start, goal);
+    written = (f != NULL) && (fwrite(goal, 1, e.keySize, f) == e.keySize);
+    if((f != NULL) && (fclose(f) != 0)) written = false;
+    e.layerCount = 1;
+    e.states = 1;
+
+    // a file not written or read whole would lose states and could end the
+    // search with a wrong answer, so any I/O failure stops it
+    stats->result = written ? SEARCH_UNSOLVABLE : SEARCH_ERROR;
+    while(written) {
+        expanded = expand_layer(&e, stats, goal, &goalMove);
+        if(expanded == EXPAND_FAILED) {
+            stats->result = SEARCH_ERROR;
+            break;
+        }
+        if(expanded == EXPAND_GOAL) {
+            // goal lies one move past the expanded layer, solution takes
+            // layerCount moves and may be too long to store whole
+            if(e.layerCount > SEARCH_MAX_DEPTH) {
+                stats->result = SEARCH_LIMIT;
+                break;
+            }
+
+            // trace the goal back through the earlier layers
+            len = 0;
+            path[len++] = goalMove;
+            for(i = e.layerCount - 2; i >= 0; i--) {
+                if(!trace_parent(&e, i, goal, &path[len])) break;
+                len++;
+            }
+            if(i >= 0) { // parent could not be read back
+                stats->result = SEARCH_ERROR;
+                break;
+            }
+            stats->result = SEARCH_SOLVED;
+            encode_solution(path, len, stats);
+            break;
+        }
+        if(e.layerCount > SEARCH_MAX_DEPTH) {
+            stats->result = SEARCH_LIMIT;
+            break;
+        }
+
+        // hand the whole budget over to merge buffers
+        free(e.buffer);
+        const long added = merge_layer(&e);
+        e.buffer = malloc(e.bufferCapacity * e.keySize);
+        if(added < 0) {
+            stats->result = SEARCH_ERROR;
+            break;
+        }
+        if(added == 0) break;
+
+        e.states += added;
+        if(e.states >= maxStates) {
+            stats->result = SEARCH_LIMIT;
+            break;
+        }
+    }
+
+    stats->states = e.states;
+
+    for(i = 0; i < e.runCount; i++) {
+        run_path(&e, i, file, sizeof(file));
+        unlink(file);
+    }
+    // layer being merged may be left over after a failure
+    for(i = 0; i <= e.layerCount; i++) {
+        layer_path(&e, i, file, sizeof(file));
+        unlink(file);
+    }
+    rmdir(e.dir);
+    free(e.buffer);
+}
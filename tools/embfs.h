@@ -0,0 +1,22 @@
+#pragma once
+
+#include "search.h"
+
+// Breadth-first search of a single level that keeps its visited set on disk,
+// for levels whose state space does not fit in memory.
+//
+// Every search depth is one file of sorted, unique state keys. Successors of
+// a layer are collected in a fixed buffer, sorted and spilled to run files;
+// the runs are then merged into the next layer while states already present
+// in any earlier layer are dropped. Merging goes in passes over a bounded
+// number of files, so memory use stays within memoryCap bytes no matter how
+// large the level is. Parents are not stored - the solution is traced back
+// by re-expanding earlier layers once the goal is found. A file that cannot
+// be written or read back whole ends the search with SEARCH_ERROR.
+
+void solve_level_external(
+    PlayGround* start,
+    const char* tempDir,
+    size_t memoryCap,
+    size_t maxStates,
+    SearchStats* stats);
@@ -0,0 +1,96 @@
+#include "heuristic.h"
+
+#include <string.h>
+
+#include "engine.h"
+
+// cost of columns where every column holds at most one brick of the type,
+// indexed by the bit mask of those columns
+static uint8_t maskCost[1 << SIZE_X];
+
+//-----------------------------------------------------------------------------
+
+// Cheapest split of sorted brick columns into groups of two or more.
+static uint8_t group_cost(const uint8_t* cols, uint8_t count) {
+    uint8_t best[SIZE_X * SIZE_Y + 1];
+    uint8_t i, j;
+
+    best[0] = 0;
+    for(i = 1; i <= count; i++) {
+        best[i] = UINT8_MAX;
+        for(j = 0; j + 2 <= i; j++) {
+            if(best[j] == UINT8_MAX) continue;
+            const int span = cols[i - 1] - cols[j];
+            const int cost = best[j] + MAX(0, span - (i - 1 - j));
+            best[i] = MIN(best[i], cost);
+        }
+    }
+
+    // a lone brick can never explode - dead boards are pruned elsewhere
+    return (best[count] == UINT8_MAX) ? 0 : best[count];
+}
+
+//-----------------------------------------------------------------------------
+
+void heuristic_init() {
+    uint8_t cols[SIZE_X];
+    uint8_t count, x;
+
+    for(uint32_t mask = 0; mask < (1 << SIZE_X); mask++) {
+        count = 0;
+        for(x = 0; x < SIZE_X; x++) {
+            if((mask & (1 << x)) != 0) cols[count++] = x;
+        }
+        maskCost[mask] = group_cost(cols, count);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+uint8_t heuristic_estimate(PlayGround* pg) {
+    uint8_t ofColumn[WALL_TILE][SIZE_X];
+    uint8_t cols[SIZE_X * SIZE_Y];
+    uint8_t x, y, tile, count;
+    uint16_t mask;
+    bool stacked;
+    int estimate = 0;
+    bool clear = true;
+
+    memset(ofColumn, '\0', sizeof(ofColumn));
+    for(y = 0; y < SIZE_Y; y++) {
+        for(x = 0; x < SIZE_X; x++) {
+            tile = (*pg)[y][x];
+            if(is_block(tile)) {
+                ofColumn[tile][x]++;
+                clear = false;
+            }
+        }
+    }
+
+    if(clear) return 0;
+
+    for(tile = 1; tile < WALL_TILE; tile++) {
+        mask = 0;
+        stacked = false;
+        for(x = 0; x < SIZE_X; x++) {
+            if(ofColumn[tile][x] > 0) mask |= (1 << x);
+            if(ofColumn[tile][x] > 1) stacked = true;
+        }
+
+        if(!stacked) {
+            estimate += maskCost[mask];
+            continue;
+        }
+
+        count = 0;
+        for(x = 0; x < SIZE_X; x++) {
+            for(y = 0; y < ofColumn[tile][x]; y++) {
+                cols[count++] = x;
+            }
+        }
+        estimate += group_cost(cols, count);
+    }
+
+    // bricks are left, so at least one more move is needed
+    return MIN(MAX(estimate, 1), UINT8_MAX);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+
+// Lower bound of moves needed to clear a board, for A* / IDA* searches.
+//
+// Gravity and explosions never move a brick sideways - only moves do, one
+// column per move. A brick explodes together with all same-type bricks it
+// touches at that moment, so a group exploding together spans at most
+// (size - 1) columns then. Bricks of a type that start spread over `span`
+// columns in a group of `n` therefore need at least `span - (n - 1)` moves,
+// and the estimate is the cheapest split of every type into such groups.
+//
+// Counting types that still need to merge would be tighter on some boards,
+// but is not admissible: one move can start a cascade clearing many types.
+
+void heuristic_init();
+uint8_t heuristic_estimate(PlayGround* pg);
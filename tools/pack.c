@@ -0,0 +1,79 @@
+#include "pack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+
+static char* field_dup(const char* start, const char* end) {
+    while((end > start) && strchr("\r\n\t ", end[-1])) {
+        end--;
+    }
+    size_t len = end - start;
+    char* str = malloc(len + 1);
+    memcpy(str, start, len);
+    str[len] = 0;
+    return str;
+}
+
+//-----------------------------------------------------------------------------
+
+static char* pack_name_from_path(const char* path) {
+    const char* base = strrchr(path, '/');
+    base = (base != NULL) ? base + 1 : path;
+    const char* ext = strstr(base, ".vxl");
+    return field_dup(base, (ext != NULL) ? ext : base + strlen(base));
+}
+
+//-----------------------------------------------------------------------------
+
+bool pack_load(const char* path, Pack* pack) {
+    FILE* f = fopen(path, "r");
+    char line[1024];
+    int capacity = 0;
+
+    memset(pack, 0, sizeof(Pack));
+    if(f == NULL) {
+        fprintf(stderr, "Cannot read file %s\n", path);
+        return false;
+    }
+
+    pack->name = pack_name_from_path(path);
+
+    while(fgets(line, sizeof(line), f) != NULL) {
+        if(line[0] == '#') continue;
+
+        char* noSep = strchr(line, ';');
+        char* nameSep = (noSep != NULL) ? strchr(noSep + 1, ';') : NULL;
+        char* boardSep = (nameSep != NULL) ? strchr(nameSep + 1, ';') : NULL;
+        if(boardSep == NULL) continue;
+
+        if(pack->count == capacity) {
+            capacity = (capacity > 0) ? capacity * 2 : 64;
+            pack->levels = realloc(pack->levels, sizeof(PackLevel) * capacity);
+        }
+
+        PackLevel* level = &pack->levels[pack->count++];
+        level->number = atoi(line);
+        level->title = field_dup(noSep + 1, nameSep);
+        level->board = field_dup(nameSep + 1, boardSep);
+        level->solution = field_dup(boardSep + 1, boardSep + strlen(boardSep));
+    }
+
+    fclose(f);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+void pack_free(Pack* pack) {
+    for(int i = 0; i < pack->count; i++) {
+        free(pack->levels[i].title);
+        free(pack->levels[i].board);
+        free(pack->levels[i].solution);
+    }
+    free(pack->levels);
+    free(pack->name);
+    memset(pack, 0, sizeof(Pack));
+}
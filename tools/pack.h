@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdbool.h>
+
+// Level pack (*.vxl) as read by the host tools, see docs/level_format.md
+
+typedef struct {
+    int number;
+    char* title;
+    char* board;
+    char* solution;
+} PackLevel;
+
+typedef struct {
+    char* name;
+    PackLevel* levels;
+    int count;
+} Pack;
+
+//-----------------------------------------------------------------------------
+
+bool pack_load(const char* path, Pack* pack);
+void pack_free(Pack* pack);
@@ -0,0 +1,361 @@
+#include "pbfs.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codec.h"
+#include "engine.h"
+
+#define PBFS_BATCH 256
+#define PBFS_INBOX 32
+
+// parent references span shards: shard number in the top bits
+#define PBFS_INDEX_BITS 26
+#define PBFS_REF(shard, index) (((uint32_t)(shard) << PBFS_INDEX_BITS) | (uint32_t)(index))
+#define PBFS_REF_SHARD(ref) ((ref) >> PBFS_INDEX_BITS)
+#define PBFS_REF_INDEX(ref) ((ref) & ((1u << PBFS_INDEX_BITS) - 1))
+
+typedef struct {
+    int count;
+    uint32_t parents[PBFS_BATCH];
+    uint8_t moves[PBFS_BATCH];
+    uint8_t keys[];
+} PbfsBatch;
+
+typedef struct {
+    pthread_mutex_t lock;
+    PbfsBatch* batches[PBFS_INBOX];
+    int head;
+    int count;
+} PbfsInbox;
+
+typedef struct Pbfs Pbfs;
+
+typedef struct {
+    Pbfs* pbfs;
+    int id;
+    StateTable table;
+    size_t layerStart;
+    size_t layerEnd;
+    size_t expanded;
+    PbfsBatch** out;
+    PbfsInbox inbox;
+} PbfsShard;
+
+struct Pbfs {
+    int threads;
+    StateCodec codec;
+    size_t keySize;
+    size_t shardLimit;
+    PbfsShard* shards;
+    pthread_barrier_t barrier;
+
+    atomic_int producing;
+    atomic_bool stop;
+
+    pthread_mutex_t goalLock;
+    bool found;
+    uint32_t goalParent;
+    uint8_t goalMove;
+
+    bool done;
+    SearchResult result;
+};
+
+//-----------------------------------------------------------------------------
+
+static PbfsBatch* batch_alloc(Pbfs* pbfs) {
+    PbfsBatch* batch = malloc(sizeof(PbfsBatch) + PBFS_BATCH * pbfs->keySize);
+    batch->count = 0;
+    return batch;
+}
+
+//-----------------------------------------------------------------------------
+
+static bool inbox_try_push(PbfsInbox* inbox, PbfsBatch* batch) {
+    bool pushed = false;
+    pthread_mutex_lock(&inbox->lock);
+    if(inbox->count < PBFS_INBOX) {
+        inbox->batches[(inbox->head + inbox->count) % PBFS_INBOX] = batch;
+        inbox->count++;
+        pushed = true;
+    }
+    pthread_mutex_unlock(&inbox->lock);
+    return pushed;
+}
+
+//-----------------------------------------------------------------------------
+
+static PbfsBatch* inbox_try_pop(PbfsInbox* inbox) {
+    PbfsBatch* batch = NULL;
+    pthread_mutex_lock(&inbox->lock);
+    if(inbox->count > 0) {
+        batch = inbox->batches[inbox->head];
+        inbox->head = (inbox->head + 1) % PBFS_INBOX;
+        inbox->count--;
+    }
+    pthread_mutex_unlock(&inbox->lock);
+    return batch;
+}
+
+//-----------------------------------------------------------------------------
+
+static bool shard_drain(PbfsShard* shard) {
+    const size_t keySize = shard->pbfs->keySize;
+    PbfsBatch* batch;
+    bool any = false;
+
+    while((batch = inbox_try_pop(&shard->inbox)) != NULL) {
+        for(int i = 0; i < batch->count; i++) {
+            state_table_insert(
+                &shard->table, &batch->keys[i * keySize], batch->parents[i], batch->moves[i]);
+        }
+        free(batch);
+        any = true;
+    }
+
+    return any;
+}
+
+//-----------------------------------------------------------------------------
+
+static void shard_send(PbfsShard* shard, int owner) {
+    PbfsBatch* batch = shard->out[owner];
+    if(batch->count == 0) return;
+
+    // never block on a full inbox without emptying our own - the owner of
+    // that inbox may be waiting for us just the same
+    while(!inbox_try_push(&shard->pbfs->shards[owner].inbox, batch)) {
+        if(!shard_drain(shard)) sched_yield();
+    }
+    shard->out[owner] = batch_alloc(shard->pbfs);
+}
+
+//-----------------------------------------------------------------------------
+
+static void shard_route(PbfsShard* shard, const uint8_t* key, uint32_t parent, uint8_t move) {
+    Pbfs* pbfs = shard->pbfs;
+    const int owner = (state_hash(key, pbfs->keySize) >> 32) % pbfs->threads;
+
+    if(owner == shard->id) {
+        state_table_insert(&shard->table, key, parent, move);
+        return;
+    }
+
+    PbfsBatch* batch = shard->out[owner];
+    memcpy(&batch->keys[batch->count * pbfs->keySize], key, pbfs->keySize);
+    batch->parents[batch->count] = parent;
+    batch->moves[batch->count] = move;
+    batch->count++;
+
+    if(batch->count == PBFS_BATCH) {
+        shard_send(shard, owner);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+static void shard_expand(PbfsShard* shard) {
+    Pbfs* pbfs = shard->pbfs;
+    PlayGround board, next;
+    MoveList moves;
+    uint8_t key[STATE_KEY_MAX];
+    uint8_t x, y, dir, m;
+
+    for(size_t i = shard->layerStart; i < shard->layerEnd; i++) {
+        if(atomic_load_explicit(&pbfs->stop, memory_order_relaxed)) break;
+        if(shard->table.count > pbfs->shardLimit) {
+            atomic_store(&pbfs->stop, true);
+            break;
+        }
+
+        decode_state(&pbfs->codec, &shard->table.keys[i * pbfs->keySize], &board);
+        shard->expanded++;
+
+        generate_moves(&board, &moves);
+        for(m = 0; m < moves.count; m++) {
+            x = BOARD_COORD_X(moves.moves[m].coord);
+            y = BOARD_COORD_Y(moves.moves[m].coord);
+            dir = moves.moves[m].dir;
+
+            memcpy(next, board, sizeof(PlayGround));
+            apply_move(&next, x, y, dir);
+            if(board_is_dead(&next)) continue;
+
+            if(board_is_clear(&next)) {
+                pthread_mutex_lock(&pbfs->goalLock);
+                if(!pbfs->found) {
+                    pbfs->found = true;
+                    pbfs->goalParent = PBFS_REF(shard->id, i);
+                    pbfs->goalMove = SEARCH_MOVE(x, y, dir);
+                }
+                pthread_mutex_unlock(&pbfs->goalLock);
+                atomic_store(&pbfs->stop, true);
+                return;
+            }
+
+            encode_state(&pbfs->codec, &next, key);
+            shard_route(shard, key, PBFS_REF(shard->id, i), SEARCH_MOVE(x, y, dir));
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+static void pbfs_next_layer(Pbfs* pbfs) {
+    size_t total = 0, added = 0;
+
+    for(int i = 0; i < pbfs->threads; i++) {
+        PbfsShard* shard = &pbfs->shards[i];
+        total += shard->table.count;
+        added += shard->table.count - shard->layerEnd;
+        shard->layerStart = shard->layerEnd;
+        shard->layerEnd = shard->table.count;
+    }
+
+    if(pbfs->found) {
+        pbfs->result = SEARCH_SOLVED;
+        pbfs->done = true;
+    } else if(atomic_load(&pbfs->stop)) {
+        pbfs->result = SEARCH_LIMIT;
+        pbfs->done = true;
+    } else if(added == 0) {
+        pbfs->result = SEARCH_UNSOLVABLE;
+        pbfs->done = true;
+    } else if(total >= pbfs->shardLimit * pbfs->threads) {
+        pbfs->result = SEARCH_LIMIT;
+        pbfs->done = true;
+    }
+
+    atomic_store(&pbfs->producing, pbfs->threads);
+}
+
+//-----------------------------------------------------------------------------
+
+static void* pbfs_worker(void* arg) {
+    PbfsShard* shard = arg;
+    Pbfs* pbfs = shard->pbfs;
+
+    while(true) {
+        shard_expand(shard);
+
+        for(int owner = 0; owner < pbfs->threads; owner++) {
+            if(owner != shard->id) shard_send(shard, owner);
+        }
+        atomic_fetch_sub(&pbfs->producing, 1);
+
+        // keep receiving until every thread has sent all of its batches
+        while(atomic_load(&pbfs->producing) > 0) {
+            if(!shard_drain(shard)) sched_yield();
+        }
+        shard_drain(shard);
+
+        pthread_barrier_wait(&pbfs->barrier);
+        if(shard->id == 0) pbfs_next_layer(pbfs);
+        pthread_barrier_wait(&pbfs->barrier);
+
+        if(pbfs->done) break;
+    }
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+static void pbfs_solution(Pbfs* pbfs, SearchStats* stats) {
+    uint8_t path[SEARCH_MAX_DEPTH];
+    uint32_t ref = pbfs->goalParent;
+    int len = 0;
+
+    path[len++] = pbfs->goalMove;
+    for(;;) {
+        StateTable* t = &pbfs->shards[PBFS_REF_SHARD(ref)].table;
+        const uint32_t index = PBFS_REF_INDEX(ref);
+        if(t->parents[index] == NO_PARENT) break;
+        // solution longer than the limit cannot be stored whole
+        if(len == SEARCH_MAX_DEPTH) {
+            stats->result = SEARCH_LIMIT;
+            return;
+        }
+        path[len++] = t->moves[index];
+        ref = t->parents[index];
+    }
+
+    encode_solution(path, len, stats);
+}
+
+//-----------------------------------------------------------------------------
+
+void solve_level_parallel(PlayGround* start, int threads, size_t maxStates, SearchStats* stats) {
+    Pbfs pbfs;
+
+    memset(stats, 0, sizeof(SearchStats));
+    if(board_is_clear(start)) {
+        stats->result = SEARCH_SOLVED;
+        return;
+    }
+
+    threads = MIN(MAX(threads, 1), PBFS_MAX_THREADS);
+    pthread_t* handles = malloc(sizeof(pthread_t) * threads);
+
+    memset(&pbfs, 0, sizeof(Pbfs));
+    pbfs.threads = threads;
+    state_codec_init(&pbfs.codec, start);
+    pbfs.keySize = pbfs.codec.keySize;
+    pbfs.shardLimit = MIN(maxStates / threads + 1, (size_t)1 << PBFS_INDEX_BITS);
+    pbfs.shards = calloc(threads, sizeof(PbfsShard));
+    pthread_barrier_init(&pbfs.barrier, NULL, threads);
+    pthread_mutex_init(&pbfs.goalLock, NULL);
+    atomic_init(&pbfs.producing, threads);
+    atomic_init(&pbfs.stop, false);
+
+    for(int i = 0; i < threads; i++) {
+        PbfsShard* shard = &pbfs.shards[i];
+        shard->pbfs = &pbfs;
+        shard->id = i;
+        state_table_init(&shard->table, pbfs.keySize);
+        pthread_mutex_init(&shard->inbox.lock, NULL);
+        shard->out = malloc(sizeof(PbfsBatch*) * threads);
+        for(int o = 0; o < threads; o++) {
+            shard->out[o] = batch_alloc(&pbfs);
+        }
+    }
+
+    uint8_t key[STATE_KEY_MAX];
+    encode_state(&pbfs.codec, start, key);
+    const int owner = (state_hash(key, pbfs.keySize) >> 32) % threads;
+    state_table_insert(&pbfs.shards[owner].table, key, NO_PARENT, 0);
+    pbfs.shards[owner].layerEnd = 1;
+
+    for(int i = 0; i < threads; i++) {
+        pthread_create(&handles[i], NULL, pbfs_worker, &pbfs.shards[i]);
+    }
+    for(int i = 0; i < threads; i++) {
+        pthread_join(handles[i], NULL);
+    }
+
+    stats->result = pbfs.result;
+    if(pbfs.result == SEARCH_SOLVED) {
+        pbfs_solution(&pbfs, stats);
+    }
+
+    for(int i = 0; i < threads; i++) {
+        PbfsShard* shard = &pbfs.shards[i];
+        stats->expanded += shard->expanded;
+        stats->states += shard->table.count;
+        for(int o = 0; o < threads; o++) {
+            free(shard->out[o]);
+        }
+        free(shard->out);
+        pthread_mutex_destroy(&shard->inbox.lock);
+        state_table_free(&shard->table);
+    }
+
+    pthread_mutex_destroy(&pbfs.goalLock);
+    pthread_barrier_destroy(&pbfs.barrier);
+    free(pbfs.shards);
+    free(handles);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "search.h"
+
+// Breadth-first search of a single level spread over several threads.
+//
+// Board states are hash-partitioned: every thread owns one shard of the
+// visited set and expands only the frontier states of its shard. Successors
+// owned by other threads are sent to them in batches through bounded
+// per-thread inboxes, so no visited set is ever shared between threads.
+// Layers are processed in lock-step, which keeps the result optimal.
+
+#define PBFS_MAX_THREADS 64
+
+void solve_level_parallel(PlayGround* start, int threads, size_t maxStates, SearchStats* stats);
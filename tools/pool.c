@@ -0,0 +1,120 @@
+#include "pool.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct {
+    pthread_mutex_t lock;
+    int head;
+    int tail;
+} PoolDeque;
+
+typedef struct {
+    PoolDeque* deques;
+    int workers;
+    PoolJobCallback callback;
+    void* ctx;
+} Pool;
+
+typedef struct {
+    Pool* pool;
+    int worker;
+} PoolWorker;
+
+//-----------------------------------------------------------------------------
+
+int pool_default_workers() {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return (cpus > 0) ? (int)cpus : 1;
+}
+
+//-----------------------------------------------------------------------------
+
+static int pool_pop_back(PoolDeque* dq) {
+    int job = -1;
+    pthread_mutex_lock(&dq->lock);
+    if(dq->head < dq->tail) {
+        job = --dq->tail;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return job;
+}
+
+//-----------------------------------------------------------------------------
+
+static int pool_steal_front(PoolDeque* dq) {
+    int job = -1;
+    pthread_mutex_lock(&dq->lock);
+    if(dq->head < dq->tail) {
+        job = dq->head++;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return job;
+}
+
+//-----------------------------------------------------------------------------
+
+static int pool_steal(Pool* pool, int thief) {
+    // jobs never spawn new jobs, so one full sweep over empty deques means done
+    for(int i = 1; i < pool->workers; i++) {
+        int job = pool_steal_front(&pool->deques[(thief + i) % pool->workers]);
+        if(job >= 0) return job;
+    }
+    return -1;
+}
+
+//-----------------------------------------------------------------------------
+
+static void* pool_worker(void* arg) {
+    PoolWorker* w = arg;
+    Pool* pool = w->pool;
+    int job;
+
+    while(true) {
+        job = pool_pop_back(&pool->deques[w->worker]);
+        if(job < 0) job = pool_steal(pool, w->worker);
+        if(job < 0) break;
+        pool->callback(pool->ctx, job, w->worker);
+    }
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+void pool_run(int workers, int count, PoolJobCallback callback, void* ctx) {
+    Pool pool;
+    pthread_t* threads = malloc(sizeof(pthread_t) * workers);
+    PoolWorker* args = malloc(sizeof(PoolWorker) * workers);
+
+    pool.deques = malloc(sizeof(PoolDeque) * workers);
+    pool.workers = workers;
+    pool.callback = callback;
+    pool.ctx = ctx;
+
+    for(int i = 0; i < workers; i++) {
+        pthread_mutex_init(&pool.deques[i].lock, NULL);
+        pool.deques[i].head = (int)(((long)count * i) / workers);
+        pool.deques[i].tail = (int)(((long)count * (i + 1)) / workers);
+    }
+
+    for(int i = 0; i < workers; i++) {
+        args[i].pool = &pool;
+        args[i].worker = i;
+        pthread_create(&threads[i], NULL, pool_worker, &args[i]);
+    }
+
+    for(int i = 0; i < workers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for(int i = 0; i < workers; i++) {
+        pthread_mutex_destroy(&pool.deques[i].lock);
+    }
+
+    free(pool.deques);
+    free(args);
+    free(threads);
+}
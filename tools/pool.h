@@ -0,0 +1,13 @@
+#pragma once
+
+// Work-stealing pool for a fixed set of independent jobs.
+//
+// Jobs 0..count-1 are split into contiguous runs, one deque per worker.
+// A worker takes jobs from the back of its own deque; once it runs dry it
+// steals from the front of the others, so a few slow jobs (hard levels)
+// do not leave the rest of the machine idle.
+
+typedef void (*PoolJobCallback)(void* ctx, int job, int worker);
+
+int pool_default_workers();
+void pool_run(int workers, int count, PoolJobCallback callback, void* ctx);
@@ -0,0 +1,401 @@
+#include "search.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "codec.h"
+#include "engine.h"
+#include "heuristic.h"
+
+//-----------------------------------------------------------------------------
+
+void state_table_init(StateTable* t, size_t keySize) {
+    memset(t, 0, sizeof(StateTable));
+    t->keySize = keySize;
+}
+
+//-----------------------------------------------------------------------------
+
+void state_table_clear(StateTable* t, size_t keySize) {
+    if(keySize != t->keySize) {
+        // stored keys are of no use with another size
+        state_table_free(t);
+        t->keySize = keySize;
+        return;
+    }
+
+    t->count = 0;
+    if(t->slots != NULL) {
+        memset(t->slots, 0, sizeof(uint32_t) * (t->slotMask + 1));
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void state_table_free(StateTable* t) {
+    free(t->keys);
+    free(t->parents);
+    free(t->moves);
+    free(t->slots);
+    state_table_init(t, t->keySize);
+}
+
+//-----------------------------------------------------------------------------
+
+uint64_t state_hash(const uint8_t* key, size_t keySize) {
+    uint64_t h = 14695981039346656037ULL;
+    for(size_t i = 0; i < keySize; i++) {
+        h = (h ^ key[i]) * 1099511628211ULL;
+    }
+    return h ^ (h >> 29);
+}
+
+//-----------------------------------------------------------------------------
+
+static void state_table_rehash(StateTable* t, size_t slotCount) {
+    free(t->slots);
+    t->slots = calloc(slotCount, sizeof(uint32_t));
+    t->slotMask = slotCount - 1;
+
+    for(size_t i = 0; i < t->count; i++) {
+        size_t s = state_hash(&t->keys[i * t->keySize], t->keySize) & t->slotMask;
+        while(t->slots[s] != 0) {
+            s = (s + 1) & t->slotMask;
+        }
+        t->slots[s] = (uint32_t)(i + 1);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+uint32_t state_table_find(StateTable* t, const uint8_t* key) {
+    if(t->count == 0) return NO_PARENT;
+
+    size_t s = state_hash(key, t->keySize) & t->slotMask;
+    while(t->slots[s] != 0) {
+        if(memcmp(&t->keys[(t->slots[s] - 1) * t->keySize], key, t->keySize) == 0) {
+            return t->slots[s] - 1;
+        }
+        s = (s + 1) & t->slotMask;
+    }
+    return NO_PARENT;
+}
+
+//-----------------------------------------------------------------------------
+
+bool state_table_insert(StateTable* t, const uint8_t* key, uint32_t parent, uint8_t move) {
+    if((t->count + 1) * 2 > t->slotMask + 1) {
+        state_table_rehash(t, (t->slotMask > 0) ? (t->slotMask + 1) * 2 : 1024);
+    }
+
+    size_t s = state_hash(key, t->keySize) & t->slotMask;
+    while(t->slots[s] != 0) {
+        if(memcmp(&t->keys[(t->slots[s] - 1) * t->keySize], key, t->keySize) == 0) {
+            return false;
+        }
+        s = (s + 1) & t->slotMask;
+    }
+
+    if(t->count == t->capacity) {
+        t->capacity = (t->capacity > 0) ? t->capacity * 2 : 1024;
+        t->keys = realloc(t->keys, t->capacity * t->keySize);
+        t->parents = realloc(t->parents, t->capacity * sizeof(uint32_t));
+        t->moves = realloc(t->moves, t->capacity);
+    }
+
+    memcpy(&t->keys[t->count * t->keySize], key, t->keySize);
+    t->parents[t->count] = parent;
+    t->moves[t->count] = move;
+    t->count++;
+    t->slots[s] = (uint32_t)t->count;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool board_is_dead(PlayGround* pg) {
+    uint8_t ofBrick[WALL_TILE];
+    count_bricks(pg, ofBrick);
+    for(uint8_t i = 0; i < WALL_TILE; i++) {
+        if(ofBrick[i] == 1) return true;
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+
+bool board_is_clear(PlayGround* pg) {
+    for(uint8_t y = 0; y < SIZE_Y; y++) {
+        for(uint8_t x = 0; x < SIZE_X; x++) {
+            if(is_block((*pg)[y][x])) return false;
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool can_move(PlayGround* pg, uint8_t x, uint8_t y, uint8_t dir) {
+    if(!is_block((*pg)[y][x])) return false;
+    if(dir == MOVABLE_LEFT) return (x > 0) && ((*pg)[y][x - 1] == EMPTY_TILE);
+    return (x < SIZE_X - 1) && ((*pg)[y][x + 1] == EMPTY_TILE);
+}
+
+//-----------------------------------------------------------------------------
+
+// Returns 0 when the solution clears the board, otherwise the 1-based number
+// of the first step that is malformed, illegal or loses the game (or one past
+// the last step when bricks are left at the end). Steps pointing at an empty
+// cell are replayed by the game as no-ops, so they are only counted.
+int verify_solution(PlayGround* pg, const char* solution, int* idleSteps) {
+    const size_t steps = strlen(solution) / 2;
+    int x, y;
+    uint8_t dir;
+
+    *idleSteps = 0;
+    for(size_t step = 0; step < steps; step++) {
+        const char solX = solution[step * 2];
+        const char solY = solution[step * 2 + 1];
+        const bool left = (solX <= 'Z');
+        const bool right = (solY <= 'Z');
+
+        x = left ? solX - 'A' : solX - 'a';
+        y = right ? solY - 'A' : solY - 'a';
+        dir = left ? MOVABLE_LEFT : MOVABLE_RIGHT;
+
+        if((left == right) || x < 0 || x >= SIZE_X || y < 0 || y >= SIZE_Y) {
+            return step + 1;
+        }
+        if((*pg)[y][x] == EMPTY_TILE) {
+            (*idleSteps)++;
+            continue;
+        }
+        if(!can_move(pg, x, y, dir)) {
+            return step + 1;
+        }
+
+        apply_move(pg, x, y, dir);
+
+        if(board_is_dead(pg)) {
+            return step + 1;
+        }
+    }
+
+    return board_is_clear(pg) ? 0 : (int)steps + 1;
+}
+
+//-----------------------------------------------------------------------------
+
+void encode_solution(const uint8_t* path, int len, SearchStats* stats) {
+    stats->depth = len;
+    for(int i = 0; i < len; i++) {
+        // path goes from the goal back to the start
+        const uint8_t move = path[len - 1 - i];
+        const uint8_t coord = move >> 1;
+        const bool right = (move & 1) != 0;
+        stats->solution[i * 2] = (right ? 'a' : 'A') + (coord % SIZE_X);
+        stats->solution[i * 2 + 1] = (right ? 'A' : 'a') + (coord / SIZE_X);
+    }
+    stats->solution[len * 2] = 0;
+}
+
+//-----------------------------------------------------------------------------
+
+static void
+    encode_table_solution(StateTable* t, uint32_t index, uint8_t lastMove, SearchStats* stats) {
+    uint8_t path[SEARCH_MAX_DEPTH];
+    int len = 0;
+
+    path[len++] = lastMove;
+    while(t->parents[index] != NO_PARENT) {
+        // solution longer than the limit cannot be stored whole
+        if(len == SEARCH_MAX_DEPTH) {
+            stats->result = SEARCH_LIMIT;
+            return;
+        }
+        path[len++] = t->moves[index];
+        index = t->parents[index];
+    }
+
+    encode_solution(path, len, stats);
+}
+
+//-----------------------------------------------------------------------------
+
+void solve_level(PlayGround* start, StateTable* t, size_t maxStates, SearchStats* stats) {
+    PlayGround board, next;
+    MoveList moves;
+    uint8_t key[STATE_KEY_MAX];
+    uint8_t x, y, dir, m;
+    StateCodec codec;
+
+    memset(stats, 0, sizeof(SearchStats));
+    state_codec_init(&codec, start);
+    state_table_clear(t, codec.keySize);
+
+    if(board_is_clear(start)) {
+        stats->result = SEARCH_SOLVED;
+        return;
+    }
+
+    encode_state(&codec, start, key);
+    state_table_insert(t, key, NO_PARENT, 0);
+
+    for(size_t head = 0; head < t->count; head++) {
+        decode_state(&codec, &t->keys[head * t->keySize], &board);
+        stats->expanded++;
+
+        generate_moves(&board, &moves);
+        for(m = 0; m < moves.count; m++) {
+            x = BOARD_COORD_X(moves.moves[m].coord);
+            y = BOARD_COORD_Y(moves.moves[m].coord);
+            dir = moves.moves[m].dir;
+
+            memcpy(next, board, sizeof(PlayGround));
+            apply_move(&next, x, y, dir);
+            if(board_is_dead(&next)) continue;
+
+            const uint8_t move = SEARCH_MOVE(x, y, dir);
+            if(board_is_clear(&next)) {
+                stats->result = SEARCH_SOLVED;
+                stats->states = t->count;
+                encode_table_solution(t, head, move, stats);
+                return;
+            }
+
+            encode_state(&codec, &next, key);
+            state_table_insert(t, key, head, move);
+            if(t->count >= maxStates) {
+                stats->result = SEARCH_LIMIT;
+                stats->states = t->count;
+                return;
+            }
+        }
+    }
+
+    stats->result = SEARCH_UNSOLVABLE;
+    stats->states = t->count;
+}
+
+//-----------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t* entries;
+    size_t count;
+    size_t capacity;
+} AStarBucket;
+
+// open list entries pack the state index with the depth it was queued at,
+// so entries left behind by a cheaper path are recognised and skipped
+#define ASTAR_ENTRY(index, g) (((uint32_t)(index) << 8) | (g))
+#define ASTAR_BUCKETS (SEARCH_MAX_DEPTH + UINT8_MAX + 1)
+
+static void astar_push(AStarBucket* bucket, uint32_t entry) {
+    if(bucket->count == bucket->capacity) {
+        bucket->capacity = (bucket->capacity > 0) ? bucket->capacity * 2 : 256;
+        bucket->entries = realloc(bucket->entries, bucket->capacity * sizeof(uint32_t));
+    }
+    bucket->entries[bucket->count++] = entry;
+}
+
+//-----------------------------------------------------------------------------
+
+// A* over the same state table as solve_level. The heuristic is admissible but
+// not consistent (an explosion can raise the estimate of what is left by more
+// than one), so states reached again by a shorter path are reopened.
+void solve_level_astar(PlayGround* start, StateTable* t, size_t maxStates, SearchStats* stats) {
+    AStarBucket buckets[ASTAR_BUCKETS];
+    uint8_t* depths = NULL;
+    size_t depthsCapacity = 0;
+    PlayGround board, next;
+    MoveList moves;
+    uint8_t key[STATE_KEY_MAX];
+    uint8_t x, y, dir, m;
+    StateCodec codec;
+    int f;
+
+    memset(stats, 0, sizeof(SearchStats));
+    memset(buckets, 0, sizeof(buckets));
+    state_codec_init(&codec, start);
+    state_table_clear(t, codec.keySize);
+    stats->result = SEARCH_UNSOLVABLE;
+
+    // entries keep 24 bits of the state index
+    maxStates = MIN(maxStates, (size_t)1 << 24);
+
+    encode_state(&codec, start, key);
+    state_table_insert(t, key, NO_PARENT, 0);
+    depthsCapacity = 1024;
+    depths = malloc(depthsCapacity);
+    depths[0] = 0;
+    astar_push(&buckets[heuristic_estimate(start)], ASTAR_ENTRY(0, 0));
+
+    for(f = 0; f < ASTAR_BUCKETS; f++) {
+        AStarBucket* bucket = &buckets[f];
+        while(bucket->count > 0) {
+            const uint32_t entry = bucket->entries[--bucket->count];
+            const uint32_t index = entry >> 8;
+            const uint8_t g = entry & 0xFF;
+            if(depths[index] != g) continue;
+
+            decode_state(&codec, &t->keys[index * t->keySize], &board);
+            if(board_is_clear(&board)) {
+                stats->result = SEARCH_SOLVED;
+                if(index > 0) {
+                    encode_table_solution(t, t->parents[index], t->moves[index], stats);
+                }
+                goto done;
+            }
+            // a cut off branch means running out is no proof of no solution
+            if(g >= SEARCH_MAX_DEPTH) {
+                stats->result = SEARCH_LIMIT;
+                continue;
+            }
+            stats->expanded++;
+
+            generate_moves(&board, &moves);
+            for(m = 0; m < moves.count; m++) {
+                x = BOARD_COORD_X(moves.moves[m].coord);
+                y = BOARD_COORD_Y(moves.moves[m].coord);
+                dir = moves.moves[m].dir;
+
+                memcpy(next, board, sizeof(PlayGround));
+                apply_move(&next, x, y, dir);
+                if(board_is_dead(&next)) continue;
+
+                const uint8_t move = SEARCH_MOVE(x, y, dir);
+                encode_state(&codec, &next, key);
+                uint32_t found = state_table_find(t, key);
+                if(found == NO_PARENT) {
+                    if(t->count >= maxStates) {
+                        stats->result = SEARCH_LIMIT;
+                        goto done;
+                    }
+                    state_table_insert(t, key, index, move);
+                    found = t->count - 1;
+                    if(t->count > depthsCapacity) {
+                        depthsCapacity *= 2;
+                        depths = realloc(depths, depthsCapacity);
+                    }
+                } else if(depths[found] <= g + 1) {
+                    continue;
+                } else {
+                    t->parents[found] = index;
+                    t->moves[found] = move;
+                }
+
+                depths[found] = g + 1;
+                astar_push(
+                    &buckets[MIN(g + 1 + heuristic_estimate(&next), ASTAR_BUCKETS - 1)],
+                    ASTAR_ENTRY(found, g + 1));
+            }
+        }
+    }
+
+done:
+    stats->states = t->count;
+    for(f = 0; f < ASTAR_BUCKETS; f++) {
+        free(buckets[f].entries);
+    }
+    free(depths);
+}
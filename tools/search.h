@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+
+// Board state searches used by the solver: replaying stored solutions and
+// breadth-first or A* search for the optimal (shortest) one.
+
+#define SEARCH_MAX_DEPTH 127
+
+#define NO_PARENT UINT32_MAX
+
+// moves are packed into a byte as (coord << 1) | goes_right
+#define SEARCH_MOVE(x, y, dir) ((((y) * SIZE_X + (x)) << 1) | ((dir) == MOVABLE_RIGHT))
+
+typedef enum {
+    SEARCH_SOLVED,
+    SEARCH_UNSOLVABLE,
+    SEARCH_LIMIT,
+    SEARCH_ERROR, // search files could not be written or read back
+} SearchResult;
+
+// Visited set and BFS queue in one: entries are appended in discovery order
+// and never removed, so a search walks them front to back. Keys are board
+// states packed by the level's StateCodec (see codec.h).
+typedef struct {
+    size_t keySize;
+    size_t count;
+    size_t capacity;
+    uint8_t* keys;
+    uint32_t* parents;
+    uint8_t* moves;
+    uint32_t* slots;
+    size_t slotMask;
+} StateTable;
+
+typedef struct {
+    SearchResult result;
+    int depth;
+    size_t expanded;
+    size_t states;
+    char solution[SEARCH_MAX_DEPTH * 2 + 1];
+} SearchStats;
+
+//-----------------------------------------------------------------------------
+
+void state_table_init(StateTable* t, size_t keySize);
+void state_table_clear(StateTable* t, size_t keySize);
+void state_table_free(StateTable* t);
+uint32_t state_table_find(StateTable* t, const uint8_t* key);
+bool state_table_insert(StateTable* t, const uint8_t* key, uint32_t parent, uint8_t move);
+uint64_t state_hash(const uint8_t* key, size_t keySize);
+
+//-----------------------------------------------------------------------------
+
+bool board_is_dead(PlayGround* pg);
+bool board_is_clear(PlayGround* pg);
+bool can_move(PlayGround* pg, uint8_t x, uint8_t y, uint8_t dir);
+void encode_solution(const uint8_t* path, int len, SearchStats* stats);
+
+int verify_solution(PlayGround* pg, const char* solution, int* idleSteps);
+void solve_level(PlayGround* start, StateTable* t, size_t maxStates, SearchStats* stats);
+void solve_level_astar(PlayGround* start, StateTable* t, size_t maxStates, SearchStats* stats);
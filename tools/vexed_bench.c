@@ -0,0 +1,221 @@
+// Vexed search benchmark (host tool)
+//
+// Solves every level of the given packs with plain breadth-first search and
+// with A* guided by the admissible heuristic, and compares the number of
+// expanded states. Both must agree on the optimal solution length. Then
+// measures throughput of the legal move generator on starting boards of all
+// levels and boards one move away from them.
+//
+//   vexed_bench [-m max_states] pack.vxl...
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "codec.h"
+#include "engine.h"
+#include "heuristic.h"
+#include "pack.h"
+#include "search.h"
+
+typedef struct {
+    int levels;
+    size_t bfsExpanded;
+    size_t astarExpanded;
+    double bfsSeconds;
+    double astarSeconds;
+} BenchTotals;
+
+//-----------------------------------------------------------------------------
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//-----------------------------------------------------------------------------
+
+static void print_totals(const char* name, BenchTotals* totals) {
+    printf(
+        "%s: %d levels, bfs %zu expanded in %.2fs, a* %zu expanded in %.2fs (%.1f%%)\n",
+        name,
+        totals->levels,
+        totals->bfsExpanded,
+        totals->bfsSeconds,
+        totals->astarExpanded,
+        totals->astarSeconds,
+        (totals->bfsExpanded > 0) ? 100.0 * totals->astarExpanded / totals->bfsExpanded : 0.0);
+}
+
+//-----------------------------------------------------------------------------
+
+typedef struct {
+    PlayGround* boards;
+    size_t count;
+    size_t capacity;
+} BoardSet;
+
+static void board_set_add(BoardSet* set, PlayGround* board) {
+    if(set->count == set->capacity) {
+        set->capacity = (set->capacity > 0) ? set->capacity * 2 : 1024;
+        set->boards = realloc(set->boards, set->capacity * sizeof(PlayGround));
+    }
+    memcpy(set->boards[set->count++], board, sizeof(PlayGround));
+}
+
+//-----------------------------------------------------------------------------
+
+// level start and every board one move later
+static void collect_boards(BoardSet* set, PlayGround* start) {
+    PlayGround next;
+    MoveList moves;
+
+    board_set_add(set, start);
+    generate_moves(start, &moves);
+    for(uint8_t m = 0; m < moves.count; m++) {
+        memcpy(next, start, sizeof(PlayGround));
+        apply_move(
+            &next,
+            BOARD_COORD_X(moves.moves[m].coord),
+            BOARD_COORD_Y(moves.moves[m].coord),
+            moves.moves[m].dir);
+        board_set_add(set, &next);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+// passes over all boards until enough time is measured, listing moves or
+// only counting them (list NULL)
+static double bench_generator(BoardSet* set, MoveList* list, size_t* generated) {
+    const double start = now_seconds();
+    double elapsed;
+
+    *generated = 0;
+    do {
+        for(size_t i = 0; i < set->count; i++) {
+            *generated += generate_moves(&set->boards[i], list);
+        }
+        elapsed = now_seconds() - start;
+    } while(elapsed < 0.5);
+
+    return elapsed;
+}
+
+//-----------------------------------------------------------------------------
+
+static void print_generator(BoardSet* set) {
+    MoveList moves;
+    size_t listed, counted;
+
+    if(set->count == 0) return;
+
+    const double listSeconds = bench_generator(set, &moves, &listed);
+    const double countSeconds = bench_generator(set, NULL, &counted);
+    printf(
+        "move generator: %zu boards, %.1fM moves/s listed, %.1fM moves/s counted\n",
+        set->count,
+        listed / listSeconds / 1e6,
+        counted / countSeconds / 1e6);
+}
+
+//-----------------------------------------------------------------------------
+
+static void usage(const char* self) {
+    fprintf(stderr, "usage: %s [-m max_states] pack.vxl...\n", self);
+    fprintf(stderr, "  -m N  skip levels that need more than N states (default 1000000)\n");
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char** argv) {
+    size_t maxStates = 1000000;
+    BenchTotals all, pack;
+    SearchStats bfs, astar;
+    StateTable table;
+    PlayGround board;
+    BoardSet boards;
+    Pack levels;
+    int mismatches = 0;
+    int skipped = 0;
+    int opt;
+
+    while((opt = getopt(argc, argv, "m:h")) != -1) {
+        switch(opt) {
+        case 'm':
+            maxStates = strtoul(optarg, NULL, 10);
+            break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if(optind >= argc) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    heuristic_init();
+    state_table_init(&table, STATE_KEY_MAX);
+    memset(&all, 0, sizeof(BenchTotals));
+    memset(&boards, 0, sizeof(BoardSet));
+
+    for(int p = optind; p < argc; p++) {
+        if(!pack_load(argv[p], &levels)) return 1;
+        memset(&pack, 0, sizeof(BenchTotals));
+
+        for(int l = 0; l < levels.count; l++) {
+            if(!parse_level_notation(levels.levels[l].board, &board)) continue;
+            collect_boards(&boards, &board);
+
+            double start = now_seconds();
+            solve_level(&board, &table, maxStates, &bfs);
+            const double bfsSeconds = now_seconds() - start;
+
+            start = now_seconds();
+            solve_level_astar(&board, &table, maxStates, &astar);
+            const double astarSeconds = now_seconds() - start;
+
+            // only levels both searches finish are comparable
+            if((bfs.result != SEARCH_SOLVED) || (astar.result != SEARCH_SOLVED)) {
+                skipped++;
+                continue;
+            }
+            if(bfs.depth != astar.depth) {
+                printf(
+                    "%s #%d: MISMATCH bfs %d, a* %d\n",
+                    levels.name,
+                    levels.levels[l].number,
+                    bfs.depth,
+                    astar.depth);
+                mismatches++;
+            }
+
+            pack.levels++;
+            pack.bfsExpanded += bfs.expanded;
+            pack.astarExpanded += astar.expanded;
+            pack.bfsSeconds += bfsSeconds;
+            pack.astarSeconds += astarSeconds;
+        }
+
+        print_totals(levels.name, &pack);
+        all.levels += pack.levels;
+        all.bfsExpanded += pack.bfsExpanded;
+        all.astarExpanded += pack.astarExpanded;
+        all.bfsSeconds += pack.bfsSeconds;
+        all.astarSeconds += pack.astarSeconds;
+        pack_free(&levels);
+    }
+
+    print_totals("total", &all);
+    printf("%d levels skipped over the state limit, %d mismatches\n", skipped, mismatches);
+    print_generator(&boards);
+
+    free(boards.boards);
+    state_table_free(&table);
+    return (mismatches > 0) ? 1 : 0;
+}
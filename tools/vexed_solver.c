@@ -0,0 +1,275 @@
+// Vexed level pack solver / verifier (host tool)
+//
+// Replays the stored solution of every level in the given packs and, with -s,
+// searches for the optimal one. Levels are spread over a work-stealing thread
+// pool and reported in pack order. With -p levels are taken one at a time
+// instead and every search is split over all threads, which suits packs with
+// a few very hard levels. With -e the visited set of each search is kept in
+// files, for levels too large for memory.
+//
+//   vexed_solver [-j threads] [-s] [-a | -p | -e MB] [-t dir] [-m max_states] pack.vxl...
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "codec.h"
+#include "embfs.h"
+#include "engine.h"
+#include "heuristic.h"
+#include "pack.h"
+#include "pbfs.h"
+#include "pool.h"
+#include "search.h"
+
+typedef struct {
+    Pack* pack;
+    PackLevel* level;
+    bool parsed;
+    int failedStep;
+    int idleSteps;
+    SearchStats search;
+    int searchFailedStep;
+    double seconds;
+} LevelJob;
+
+typedef struct {
+    LevelJob* jobs;
+    int count;
+    bool solve;
+    bool astar;
+    bool parallel;
+    size_t externalMemory;
+    const char* tempDir;
+    int workers;
+    size_t maxStates;
+    StateTable* tables;
+
+    pthread_mutex_t printLock;
+    bool* done;
+    int nextToPrint;
+    int failures;
+} Solver;
+
+//-----------------------------------------------------------------------------
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//-----------------------------------------------------------------------------
+
+static void print_job(LevelJob* job) {
+    const int par = strlen(job->level->solution) / 2;
+
+    printf("%s #%d %s: ", job->pack->name, job->level->number, job->level->title);
+    if(!job->parsed) {
+        printf("INVALID BOARD");
+    } else if(job->failedStep > 0) {
+        printf("SOLUTION FAILS AT STEP %d of %d", job->failedStep, par);
+    } else {
+        printf("ok, par %d", par);
+        if(job->idleSteps > 0) {
+            printf(" (%d idle steps)", job->idleSteps);
+        }
+    }
+
+    if(job->parsed && ((job->search.expanded > 0) || (job->search.result == SEARCH_ERROR))) {
+        switch(job->search.result) {
+        case SEARCH_SOLVED:
+            printf(
+                ", optimal %d (%s)%s",
+                job->search.depth,
+                job->search.solution,
+                (job->search.depth < par) ? " BEATS PAR" : "");
+            if(job->searchFailedStep > 0) {
+                printf(" BUT FAILS AT STEP %d", job->searchFailedStep);
+            }
+            break;
+        case SEARCH_UNSOLVABLE:
+            printf(", no solution found");
+            break;
+        case SEARCH_ERROR:
+            printf(", SEARCH FAILED ON I/O ERROR");
+            break;
+        case SEARCH_LIMIT:
+        default:
+            printf(", search gave up");
+            break;
+        }
+        printf(", %zu states, %.2fs", job->search.states, job->seconds);
+    }
+    printf("\n");
+}
+
+//-----------------------------------------------------------------------------
+
+static void solver_job(void* ctx, int index, int worker) {
+    Solver* solver = ctx;
+    LevelJob* job = &solver->jobs[index];
+    PlayGround board;
+    const double start = now_seconds();
+
+    job->parsed = parse_level_notation(job->level->board, &board);
+    if(job->parsed) {
+        if(solver->solve && (solver->externalMemory > 0)) {
+            solve_level_external(
+                &board,
+                solver->tempDir,
+                solver->externalMemory,
+                solver->maxStates,
+                &job->search);
+        } else if(solver->solve && solver->parallel) {
+            solve_level_parallel(&board, solver->workers, solver->maxStates, &job->search);
+        } else if(solver->solve && solver->astar) {
+            solve_level_astar(&board, &solver->tables[worker], solver->maxStates, &job->search);
+        } else if(solver->solve) {
+            solve_level(&board, &solver->tables[worker], solver->maxStates, &job->search);
+        }
+        job->failedStep = verify_solution(&board, job->level->solution, &job->idleSteps);
+        if(job->search.result == SEARCH_SOLVED) {
+            int idle;
+            job->searchFailedStep = verify_solution(&board, job->search.solution, &idle);
+        }
+    }
+    job->seconds = now_seconds() - start;
+
+    // print finished levels in pack order, as soon as all earlier ones are done
+    pthread_mutex_lock(&solver->printLock);
+    solver->done[index] = true;
+    if(!job->parsed || (job->failedStep > 0) || (job->searchFailedStep > 0) ||
+       (job->search.result == SEARCH_ERROR)) {
+        solver->failures++;
+    }
+    while((solver->nextToPrint < solver->count) && solver->done[solver->nextToPrint]) {
+        print_job(&solver->jobs[solver->nextToPrint]);
+        solver->nextToPrint++;
+    }
+    fflush(stdout);
+    pthread_mutex_unlock(&solver->printLock);
+}
+
+//-----------------------------------------------------------------------------
+
+static void usage(const char* self) {
+    fprintf(stderr, "usage: %s [-j threads] [-s] [-a | -p | -e MB] [-t dir] [-m max_states] pack.vxl...\n",
+        self);
+    fprintf(stderr, "  -j N  worker threads (default: all CPUs)\n");
+    fprintf(stderr, "  -s    also search for optimal solutions\n");
+    fprintf(stderr, "  -a    search with A* instead of breadth-first\n");
+    fprintf(stderr, "  -p    solve one level at a time, searching on all threads\n");
+    fprintf(stderr, "  -e N  solve one level at a time, visited states on disk, N MB of memory\n");
+    fprintf(stderr, "  -t D  directory for -e files (default: $TMPDIR or /tmp)\n");
+    fprintf(stderr, "  -m N  give up a level search after N states (default 4000000)\n");
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char** argv) {
+    Solver solver;
+    int workers = pool_default_workers();
+    int opt;
+
+    memset(&solver, 0, sizeof(Solver));
+    solver.maxStates = 4000000;
+
+    while((opt = getopt(argc, argv, "j:sape:t:m:h")) != -1) {
+        switch(opt) {
+        case 'j':
+            workers = atoi(optarg);
+            break;
+        case 's':
+            solver.solve = true;
+            break;
+        case 'a':
+            solver.astar = true;
+            break;
+        case 'p':
+            solver.parallel = true;
+            break;
+        case 'e':
+            solver.externalMemory = strtoul(optarg, NULL, 10) << 20;
+            break;
+        case 't':
+            solver.tempDir = optarg;
+            break;
+        case 'm':
+            solver.maxStates = strtoul(optarg, NULL, 10);
+            break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    const int packCount = argc - optind;
+    if((packCount <= 0) || (workers <= 0)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    Pack* packs = calloc(packCount, sizeof(Pack));
+    for(int i = 0; i < packCount; i++) {
+        if(!pack_load(argv[optind + i], &packs[i])) return 1;
+        solver.count += packs[i].count;
+    }
+
+    solver.jobs = calloc(solver.count, sizeof(LevelJob));
+    solver.done = calloc(solver.count, sizeof(bool));
+    for(int i = 0, n = 0; i < packCount; i++) {
+        for(int l = 0; l < packs[i].count; l++, n++) {
+            solver.jobs[n].pack = &packs[i];
+            solver.jobs[n].level = &packs[i].levels[l];
+        }
+    }
+
+    // each worker keeps its own transposition table, reused between levels
+    solver.tables = calloc(workers, sizeof(StateTable));
+    for(int i = 0; i < workers; i++) {
+        state_table_init(&solver.tables[i], STATE_KEY_MAX);
+    }
+
+    heuristic_init();
+    if(solver.tempDir == NULL) {
+        solver.tempDir = (getenv("TMPDIR") != NULL) ? getenv("TMPDIR") : "/tmp";
+    }
+
+    solver.workers = workers;
+    pthread_mutex_init(&solver.printLock, NULL);
+    const double start = now_seconds();
+    if(solver.parallel || (solver.externalMemory > 0)) {
+        for(int i = 0; i < solver.count; i++) {
+            solver_job(&solver, i, 0);
+        }
+    } else {
+        pool_run(workers, solver.count, solver_job, &solver);
+    }
+    const double elapsed = now_seconds() - start;
+    pthread_mutex_destroy(&solver.printLock);
+
+    printf(
+        "%d levels in %d packs, %d failed, %.2fs on %d threads\n",
+        solver.count,
+        packCount,
+        solver.failures,
+        elapsed,
+        workers);
+
+    for(int i = 0; i < workers; i++) {
+        state_table_free(&solver.tables[i]);
+    }
+    for(int i = 0; i < packCount; i++) {
+        pack_free(&packs[i]);
+    }
+    free(solver.tables);
+    free(solver.done);
+    free(solver.jobs);
+    free(packs);
+
+    return (solver.failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,160 @@
+// Vexed play telemetry report (host tool)
+//
+// Reads telemetry.bin copied from apps_data/game_vexed on the SD card and
+// prints attempts of every level played, oldest records first dropped by the
+// device ring. Level sets are stored as hashes of their names - packs given
+// on command line are hashed the same way to name them in the report.
+//
+//   vexed_stats telemetry.bin [pack.vxl...]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pack.h"
+#include "telemetry.h"
+
+typedef struct {
+    uint32_t setHash;
+    uint8_t level;
+    int attempts;
+    int outcomes[TelemetryOutcomeCount];
+    int solutionViewed;
+    unsigned long moves;
+    unsigned long undos;
+    unsigned long ms;
+    int bestMoves; // fewest moves of finished attempts, 0 if none
+} LevelStats;
+
+typedef struct {
+    uint32_t hash;
+    char* name;
+} SetName;
+
+//-----------------------------------------------------------------------------
+
+static LevelStats* find_level(LevelStats* levels, int* count, uint32_t setHash, uint8_t level) {
+    for(int i = 0; i < *count; i++) {
+        if((levels[i].setHash == setHash) && (levels[i].level == level)) return &levels[i];
+    }
+
+    LevelStats* ls = &levels[(*count)++];
+    memset(ls, 0, sizeof(LevelStats));
+    ls->setHash = setHash;
+    ls->level = level;
+    return ls;
+}
+
+//-----------------------------------------------------------------------------
+
+static int compare_levels(const void* a, const void* b) {
+    const LevelStats* la = a;
+    const LevelStats* lb = b;
+    if(la->setHash != lb->setHash) return (la->setHash < lb->setHash) ? -1 : 1;
+    return (int)la->level - (int)lb->level;
+}
+
+//-----------------------------------------------------------------------------
+
+static void usage(const char* self) {
+    fprintf(stderr, "usage: %s telemetry.bin [pack.vxl...]\n", self);
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char** argv) {
+    TelemetryHeader header;
+    TelemetryRecord record;
+    Pack pack;
+    SetName* names;
+    int nameCount = 0;
+    int levelCount = 0;
+
+    if(argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE* f = fopen(argv[1], "rb");
+    if(f == NULL) {
+        fprintf(stderr, "Cannot read file %s\n", argv[1]);
+        return 1;
+    }
+    if((fread(&header, sizeof(TelemetryHeader), 1, f) != 1) || !telemetry_header_valid(&header)) {
+        fprintf(stderr, "%s is not a telemetry file of version %d\n", argv[1], TELEMETRY_VERSION);
+        fclose(f);
+        return 1;
+    }
+
+    names = calloc(argc, sizeof(SetName));
+    for(int p = 2; p < argc; p++) {
+        if(!pack_load(argv[p], &pack)) continue;
+        names[nameCount].hash = telemetry_set_hash(pack.name);
+        names[nameCount].name = strdup(pack.name);
+        nameCount++;
+        pack_free(&pack);
+    }
+
+    // ring keeps at most capacity records, the oldest ones are overwritten
+    const uint32_t kept = MIN(header.written, (uint32_t)TELEMETRY_CAPACITY);
+    LevelStats* levels = calloc(kept + 1, sizeof(LevelStats));
+
+    for(uint32_t i = header.written - kept; i < header.written; i++) {
+        if((fseek(f, telemetry_record_offset(i), SEEK_SET) != 0) ||
+           (fread(&record, sizeof(TelemetryRecord), 1, f) != 1)) {
+            fprintf(stderr, "%s is cut short at record %u\n", argv[1], i);
+            break;
+        }
+        if(record.outcome >= TelemetryOutcomeCount) continue;
+
+        LevelStats* ls = find_level(levels, &levelCount, record.setHash, record.level);
+        ls->attempts++;
+        ls->outcomes[record.outcome]++;
+        ls->solutionViewed += (record.flags & TELEMETRY_SOLUTION_VIEWED) ? 1 : 0;
+        ls->moves += record.moves;
+        ls->undos += record.undos;
+        ls->ms += record.endTick - record.startTick;
+        if((record.outcome == TelemetryFinished) &&
+           ((ls->bestMoves == 0) || (record.moves < ls->bestMoves))) {
+            ls->bestMoves = record.moves;
+        }
+    }
+    fclose(f);
+
+    qsort(levels, levelCount, sizeof(LevelStats), compare_levels);
+
+    printf("%u attempts recorded, %u kept\n", header.written, kept);
+    for(int i = 0; i < levelCount; i++) {
+        LevelStats* ls = &levels[i];
+        const char* name = NULL;
+        for(int n = 0; n < nameCount; n++) {
+            if(names[n].hash == ls->setHash) name = names[n].name;
+        }
+
+        if(name != NULL) {
+            printf("%s #%u:", name, ls->level);
+        } else {
+            printf("%08x #%u:", ls->setHash, ls->level);
+        }
+        printf(
+            " %d tries, %d finished (best %d), %d stuck, %d bricks left, %d left, "
+            "%d solution views, avg %.1f moves %.1f undos %.0fs\n",
+            ls->attempts,
+            ls->outcomes[TelemetryFinished],
+            ls->bestMoves,
+            ls->outcomes[TelemetryCannotMove],
+            ls->outcomes[TelemetryBricksLeft],
+            ls->outcomes[TelemetryAbandoned],
+            ls->solutionViewed,
+            (double)ls->moves / ls->attempts,
+            (double)ls->undos / ls->attempts,
+            ls->ms / 1000.0 / ls->attempts);
+    }
+
+    for(int n = 0; n < nameCount; n++) {
+        free(names[n].name);
+    }
+    free(names);
+    free(levels);
+    return 0;
+}
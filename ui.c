@@ -1,43 +1,46 @@
 #include "ui.h"
 
 #include <gui/icon_i.h>
+#include <gui/canvas_i.h>
+#include "common.h"
 #include "fonts.h"
 #include "game_vexed_icons.h"
 
 //-----------------------------------------------------------------------------
 
+// indexed by tile; empty tile maps to wall, as used by menu backgrounds
+static const Icon* const tileIcons[TILE_ICON_COUNT] =
+    {&I_w, &I_a, &I_b, &I_c, &I_alt_d, &I_e, &I_f, &I_g, &I_h, &I_w};
+static const Icon* const tileIconsGameOver[TILE_ICON_COUNT] =
+    {&I_w_black, &I_a, &I_b, &I_c, &I_alt_d, &I_e, &I_f, &I_g, &I_h, &I_w_black};
+
+const Icon* const* tile_icons(bool gameOver) {
+    return gameOver ? tileIconsGameOver : tileIcons;
+}
+
+//-----------------------------------------------------------------------------
+
 const Icon* tile_to_icon(uint8_t tile, bool gameOver) {
-    switch(tile) {
-    case 1:
-        return &I_a;
-    case 2:
-        return &I_b;
-    case 3:
-        return &I_c;
-    case 4:
-        return &I_alt_d;
-    case 5:
-        return &I_e;
-    case 6:
-        return &I_f;
-    case 7:
-        return &I_g;
-    case 8:
-        return &I_h;
-    case 9:
-    default:
-        return gameOver ? &I_w_black : &I_w;
-    };
+    return tile_icons(gameOver)[MIN(tile, (uint8_t)WALL_TILE)];
 }
 
 //-----------------------------------------------------------------------------
 
+// Display buffer is organised in pages of 8 rows, one byte per column with
+// the top row in the lowest bit. Keeping even rows in even columns and odd
+// rows in odd ones gives a checkerboard; four columns fit in one word.
+#define DITHER_EVEN_COLUMN 0x55
+#define DITHER_ODD_COLUMN 0xAA
+#define DITHER_WORD 0xAA55AA55
+
+// Whole screen checkerboard is the same turned upside down, so it does not
+// depend on canvas orientation
 void gray_canvas(Canvas* const canvas) {
-    canvas_set_color(canvas, ColorWhite);
-    for(int x = 0; x < GUI_DISPLAY_WIDTH; x += 2) {
-        for(int y = 0; y < GUI_DISPLAY_HEIGHT; y++) {
-            canvas_draw_dot(canvas, x + (y % 2 == 1 ? 0 : 1), y);
-        }
+    uint32_t* words = (uint32_t*)canvas_get_buffer(canvas);
+    const size_t count = canvas_get_buffer_size(canvas) / sizeof(uint32_t);
+
+    for(size_t i = 0; i < count; i++) {
+        words[i] &= DITHER_WORD;
     }
 }
 
@@ -59,10 +62,44 @@ void set_bounding_box(
 //-----------------------------------------------------------------------------
 
 void mask_canvas(Canvas* const canvas, uint8_t sx, uint8_t sy, uint8_t w, uint8_t h) {
-    canvas_set_color(canvas, ColorWhite);
-    for(uint8_t x = sx; x < sx + w; x += 2) {
-        for(uint8_t y = sy; y < sy + h; y++) {
-            canvas_draw_dot(canvas, x + (y % 2 == 1 ? 0 : 1), y);
+    uint8_t* buffer = canvas_get_buffer(canvas);
+    uint8_t ex = MIN(sx + ((w + 1) & ~1), GUI_DISPLAY_WIDTH);
+    uint8_t ey = MIN(sy + h, GUI_DISPLAY_HEIGHT);
+    const uint8_t parity = sx % 2;
+    uint8_t page, x, y, rows, keep;
+
+    switch(canvas_get_orientation(canvas)) {
+    case CanvasOrientationHorizontal:
+        break;
+    case CanvasOrientationHorizontalFlip:
+        // left-handed mode: buffer holds the picture turned upside down, so
+        // the area is mirrored; turning keeps parity of the checkerboard
+        x = sx;
+        y = sy;
+        sx = GUI_DISPLAY_WIDTH - ex;
+        sy = GUI_DISPLAY_HEIGHT - ey;
+        ex = GUI_DISPLAY_WIDTH - x;
+        ey = GUI_DISPLAY_HEIGHT - y;
+        break;
+    default:
+        canvas_set_color(canvas, ColorWhite);
+        for(x = sx; x < ex; x += 2) {
+            for(y = sy; y < ey; y++) {
+                canvas_draw_dot(canvas, x + (y % 2 == 1 ? 0 : 1), y);
+            }
+        }
+        return;
+    }
+
+    // checkerboard starts at the left edge of the area, columns go in pairs
+    for(page = sy / 8; page * 8 < ey; page++) {
+        rows = 0xFF;
+        if(page * 8 < sy) rows &= 0xFF << (sy - page * 8);
+        if(page * 8 + 8 > ey) rows &= 0xFF >> (page * 8 + 8 - ey);
+
+        for(x = sx; x < ex; x++) {
+            keep = ((x + parity) % 2 == 0) ? DITHER_EVEN_COLUMN : DITHER_ODD_COLUMN;
+            buffer[page * GUI_DISPLAY_WIDTH + x] &= keep | ~rows;
         }
     }
 }
@@ -165,23 +202,15 @@ size_t elements_get_max_chars_to_fit(
 
 //-----------------------------------------------------------------------------
 
-void elements_multiline_text_aligned_limited(
-    Canvas* canvas,
-    BoundingBox* box,
-    uint8_t x,
-    uint8_t y,
-    uint8_t h,
-    Align horizontal,
-    Align vertical,
-    const char* text) {
-    furi_assert(canvas);
-    furi_assert(box);
-    furi_assert(text);
-
+static void text_layout_build(TextLayout* layout, Canvas* canvas, const char* text) {
+    BoundingBox* box = &layout->key.box;
+    const Align horizontal = layout->key.horizontal;
+    const uint8_t x = layout->key.x;
+    const uint8_t h = MIN(layout->key.h, (uint8_t)TEXT_LAYOUT_LINES);
+    uint8_t y = layout->key.y;
     uint8_t lines_count = 0;
     uint8_t lineNo = 0;
     uint8_t font_height = canvas_current_font_height(canvas);
-    FuriString* line;
 
     /* go through text line by line and count lines */
     for(const char* start = text; start[0];) {
@@ -194,31 +223,28 @@ void elements_multiline_text_aligned_limited(
     bool overflow = lines_count > h;
     lines_count = MIN(lines_count, h);
 
-    if(vertical == AlignBottom) {
+    if(layout->key.vertical == AlignBottom) {
         y -= font_height * (lines_count - 1);
-    } else if(vertical == AlignCenter) {
+    } else if(layout->key.vertical == AlignCenter) {
         y -= (font_height * (lines_count - 1)) / 2;
     }
 
-    /* go through text line by line and print them */
+    layout->top = y;
+    layout->lineHeight = font_height;
+
+    /* go through text line by line and remember what to print */
     for(const char* start = text; start[0];) {
         size_t chars_fit = elements_get_max_chars_to_fit(canvas, box, horizontal, start, x);
-        lineNo++;
+        layout->start[lineNo] = start - text;
+        layout->length[lineNo] = MIN(chars_fit, (size_t)TEXT_LAYOUT_LINE_SIZE);
         if((start[chars_fit] == '\n') || (start[chars_fit] == 0)) {
-            line = furi_string_alloc_printf("%.*s", chars_fit, start);
-        } else if(((y + font_height) > canvas_height(canvas)) || ((lineNo >= h) && overflow)) {
-            line = furi_string_alloc_printf("%.*s...\n", chars_fit, start);
+            layout->suffix[lineNo] = TextLineEnd;
+        } else if(((y + font_height) > canvas_height(canvas)) || ((lineNo + 1 >= h) && overflow)) {
+            layout->suffix[lineNo] = TextLineEllipsis;
         } else {
-            line = furi_string_alloc_printf("%.*s\n", chars_fit, start);
+            layout->suffix[lineNo] = TextLineBreak;
         }
-        canvas_draw_str_aligned(
-            canvas,
-            x + box->offset_x,
-            y + box->offset_y,
-            horizontal,
-            vertical,
-            furi_string_get_cstr(line));
-        furi_string_free(line);
+        lineNo++;
         y += font_height;
         if(y > canvas_height(canvas)) {
             break;
@@ -230,6 +256,73 @@ void elements_multiline_text_aligned_limited(
         start += chars_fit;
         start += start[0] == '\n' ? 1 : 0;
     }
+
+    layout->lineCount = lineNo;
+}
+
+//-----------------------------------------------------------------------------
+
+void elements_multiline_text_aligned_limited(
+    Canvas* canvas,
+    TextLayout* layout,
+    uint32_t textRev,
+    BoundingBox* box,
+    uint8_t x,
+    uint8_t y,
+    uint8_t h,
+    Align horizontal,
+    Align vertical,
+    const uint8_t* font,
+    const char* text) {
+    furi_assert(canvas);
+    furi_assert(box);
+    furi_assert(text);
+
+    TextLayout uncached;
+    TextLayoutKey key;
+    char line[TEXT_LAYOUT_LINE_SIZE + 5];
+
+    if(layout == NULL) {
+        layout = &uncached;
+        layout->valid = false;
+    }
+
+    memset(&key, 0, sizeof(TextLayoutKey));
+    key.textRev = textRev;
+    key.font = font;
+    key.box = *box;
+    key.x = x;
+    key.y = y;
+    key.h = h;
+    key.horizontal = horizontal;
+    key.vertical = vertical;
+
+    canvas_set_custom_u8g2_font(canvas, font);
+
+    if(!layout->valid || (memcmp(&key, &layout->key, sizeof(TextLayoutKey)) != 0)) {
+        layout->key = key;
+        text_layout_build(layout, canvas, text);
+        layout->valid = true;
+    }
+
+    for(uint8_t i = 0; i < layout->lineCount; i++) {
+        const uint8_t length = layout->length[i];
+        memcpy(line, text + layout->start[i], length);
+        line[length] = 0;
+        if(layout->suffix[i] == TextLineEllipsis) {
+            strcat(line, "...\n");
+        } else if(layout->suffix[i] == TextLineBreak) {
+            strcat(line, "\n");
+        }
+
+        canvas_draw_str_aligned(
+            canvas,
+            x + box->offset_x,
+            (uint8_t)(layout->top + i * layout->lineHeight) + box->offset_y,
+            horizontal,
+            vertical,
+            line);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -265,8 +358,8 @@ void menu_pill(
     UNUSED(count);
 
     uint8_t height = 12;
-    uint8_t y_offset = 4;
-    uint8_t menu_pad_v = 4;
+    uint8_t y_offset = 2;
+    uint8_t menu_pad_v = 3;
     uint8_t menu_pad_h = 8;
     uint8_t menu_total_w = 114;
 
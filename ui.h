@@ -22,6 +22,9 @@ void set_bounding_box(
     uint8_t width,
     uint8_t height);
 
+#define TILE_ICON_COUNT 10 // empty, 8 bricks and wall
+
+const Icon* const* tile_icons(bool gameOver);
 const Icon* tile_to_icon(uint8_t tile, bool gameOver);
 
 void gray_canvas(Canvas* const canvas);
@@ -29,15 +32,53 @@ void mask_canvas(Canvas* const canvas, uint8_t sx, uint8_t sy, uint8_t w, uint8_
 void canvas_draw_hline_dotted(Canvas* const canvas, uint8_t x, uint8_t y, uint8_t w);
 void canvas_draw_vline_dotted(Canvas* const canvas, uint8_t x, uint8_t y, uint8_t h);
 
+#define TEXT_LAYOUT_LINES 4
+#define TEXT_LAYOUT_LINE_SIZE 64
+
+typedef enum {
+    TextLineEnd,
+    TextLineBreak,
+    TextLineEllipsis,
+} TextLineSuffix;
+
+// What the line breaks depend on. Text is identified by a revision that
+// changes with its content, as it is drawn from whichever render snapshot
+// is current and its address alternates
+typedef struct {
+    uint32_t textRev;
+    const uint8_t* font;
+    BoundingBox box;
+    uint8_t x;
+    uint8_t y;
+    uint8_t h;
+    Align horizontal;
+    Align vertical;
+} TextLayoutKey;
+
+// Line breaks of multiline text, measured once and reused while key matches
+typedef struct {
+    TextLayoutKey key;
+    bool valid;
+    uint8_t top;
+    uint8_t lineHeight;
+    uint8_t lineCount;
+    uint16_t start[TEXT_LAYOUT_LINES];
+    uint8_t length[TEXT_LAYOUT_LINES];
+    TextLineSuffix suffix[TEXT_LAYOUT_LINES];
+} TextLayout;
+
 void elements_button_right_back(Canvas* canvas, const char* str);
 void elements_multiline_text_aligned_limited(
     Canvas* canvas,
+    TextLayout* layout,
+    uint32_t textRev,
     BoundingBox* box,
     uint8_t x,
     uint8_t y,
     uint8_t h,
     Align horizontal,
     Align vertical,
+    const uint8_t* font,
     const char* text);
 
 void hint_pill_single(Canvas* canvas, const char* str);
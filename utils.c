@@ -1,9 +1,5 @@
 #include "utils.h"
 
-bool is_block(uint8_t tile) {
-    return (tile > 0) && (tile != WALL_TILE);
-}
-
 uint8_t cap_x(uint8_t coord) {
     return MIN(MAX(0, coord), (SIZE_X - 1));
 }
@@ -16,6 +12,43 @@ bool is_state_pause(State gameState) {
     return ((gameState < ABOUT) || (gameState >= PAUSED));
 }
 
+bool is_state_animating(State gameState) {
+    return (gameState == MOVE_SIDES) || (gameState == MOVE_GRAVITY) || (gameState == EXPLODE);
+}
+
+uint32_t frame_period(Game* game) {
+    const State gameState = game->state;
+
+    // flash after instant move may be over paused dialog
+    if(game->flashSteps > 0) {
+        return furi_kernel_get_tick_frequency() / SIM_STEPS_PER_SECOND;
+    }
+
+    if(is_state_pause(gameState) && (gameState != INTRO)) {
+        return 0;
+    }
+
+    switch(gameState) {
+    case SOLUTION_SELECT:
+        // paused playback only waits for player
+        return furi_kernel_get_tick_frequency() /
+               (game->solutionPaused ? IDLE_FRAMES_PER_SECOND : SIM_STEPS_PER_SECOND);
+    case INTRO:
+    case ABOUT:
+    case MOVE_SIDES:
+    case MOVE_GRAVITY:
+    case EXPLODE:
+        return furi_kernel_get_tick_frequency() / SIM_STEPS_PER_SECOND;
+    default:
+        // waiting for player, only selection blinks
+        return furi_kernel_get_tick_frequency() / IDLE_FRAMES_PER_SECOND;
+    }
+}
+
+bool blink_phase(uint32_t halfPeriodMs) {
+    return ((furi_get_tick() / furi_ms_to_ticks(halfPeriodMs)) % 2) == 0;
+}
+
 void copy_level(PlayGround target, PlayGround source) {
     memcpy(target, source, sizeof(uint8_t) * SIZE_X * SIZE_Y);
 }
@@ -3,11 +3,14 @@
 #include <furi.h>
 
 #include "game.h"
+#include "engine.h"
 
-bool is_block(uint8_t tile);
 uint8_t cap_x(uint8_t coord);
 uint8_t cap_y(uint8_t coord);
 bool is_state_pause(State gameState);
+bool is_state_animating(State gameState);
+uint32_t frame_period(Game* game);
+bool blink_phase(uint32_t halfPeriodMs);
 void copy_level(PlayGround target, PlayGround source);
 void clear_board(PlayGround* ani);
 void randomize_bg(BackGround* bg);
@@ -0,0 +1,251 @@
+#include "walls.h"
+
+#include "game.h"
+
+#define PIXELS_X (SIZE_X * TILE_SIZE)
+#define PIXELS_Y (SIZE_Y * TILE_SIZE)
+
+#define PIXEL_NONE 0
+#define PIXEL_BLACK 1
+#define PIXEL_WHITE 2
+#define PIXEL_DONE 3
+
+typedef struct {
+    uint8_t* pixels;
+    uint8_t color;
+} WallPen;
+
+//-----------------------------------------------------------------------------
+
+static void pen_line(WallPen* pen, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
+    // wall outlines only ever use straight lines
+    for(uint8_t y = MIN(y0, y1); y <= MAX(y0, y1); y++) {
+        for(uint8_t x = MIN(x0, x1); x <= MAX(x0, x1); x++) {
+            pen->pixels[y * PIXELS_X + x] = pen->color;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+static void pen_dot(WallPen* pen, uint8_t x, uint8_t y) {
+    pen_line(pen, x, y, x, y);
+}
+
+//-----------------------------------------------------------------------------
+
+// Same strokes as were drawn around every wall tile on each frame.
+static void paint_wall(WallPen* pen, PlayGround* pg, uint8_t x, uint8_t y, bool whiteB) {
+    Neighbors tiles = find_neighbors(pg, x, y);
+
+    uint8_t sx = x * TILE_SIZE;
+    uint8_t sy = y * TILE_SIZE;
+    uint8_t ex = ((x + 1) * TILE_SIZE) - 1;
+    uint8_t ey = ((y + 1) * TILE_SIZE) - 1;
+
+    // UP
+    if(tiles.u != WALL_TILE) {
+        pen->color = PIXEL_BLACK;
+        pen_line(pen, sx, sy + 1, ex, sy + 1);
+
+        pen->color = PIXEL_WHITE;
+        pen_line(pen, sx, sy, ex, sy);
+        if(whiteB) pen_line(pen, sx, sy + 2, ex, sy + 2);
+    }
+
+    // DOWN
+    if(tiles.d != WALL_TILE) {
+        pen->color = PIXEL_BLACK;
+        pen_line(pen, sx, ey, ex, ey);
+        pen->color = PIXEL_WHITE;
+        if(whiteB) pen_line(pen, sx, ey - 1, ex, ey - 1);
+    }
+
+    // LEFT
+    if(tiles.l != WALL_TILE) {
+        pen->color = PIXEL_BLACK;
+        pen_line(pen, sx + 1, sy + ((tiles.u != WALL_TILE) ? 1 : 0), sx + 1, ey);
+
+        pen->color = PIXEL_WHITE;
+        pen_line(pen, sx, sy, sx, ey);
+        if(whiteB)
+            pen_line(
+                pen,
+                sx + 2,
+                sy + ((tiles.u != WALL_TILE) ? 2 : 0),
+                sx + 2,
+                ey - ((tiles.d != WALL_TILE) ? 2 : 0));
+    }
+
+    // RIGHT
+    if(tiles.r != WALL_TILE) {
+        pen->color = PIXEL_BLACK;
+        pen_line(pen, ex, (sy) + ((tiles.u != WALL_TILE) ? 1 : 0), ex, ey);
+        pen->color = PIXEL_WHITE;
+        if(whiteB)
+            pen_line(
+                pen,
+                ex - 1,
+                sy + ((tiles.u != WALL_TILE) ? 2 : 0),
+                ex - 1,
+                ey - ((tiles.d != WALL_TILE) ? 2 : 0));
+    }
+
+    if((tiles.dl != WALL_TILE) && (tiles.l == WALL_TILE)) {
+        pen->color = PIXEL_BLACK;
+        pen_line(pen, sx, ey, sx + 1, ey);
+        pen->color = PIXEL_WHITE;
+        if(whiteB) pen_line(pen, sx, ey - 1, sx + 2, ey - 1);
+    }
+
+    if((tiles.ur != WALL_TILE) && (tiles.u == WALL_TILE)) {
+        pen->color = PIXEL_BLACK;
+        pen_line(pen, ex, sy, ex, sy + 1);
+        pen->color = PIXEL_WHITE;
+        if(whiteB) pen_line(pen, ex - 1, sy, ex - 1, sy + 2);
+    }
+
+    if(tiles.ul != WALL_TILE) {
+        pen->color = PIXEL_WHITE;
+        pen_dot(pen, sx, sy);
+        if(whiteB) pen_dot(pen, sx + 2, sy + 2);
+        if(tiles.l == WALL_TILE) {
+            pen->color = PIXEL_BLACK;
+            pen_line(pen, sx, sy + 1, sx + 1, sy + 1);
+            pen->color = PIXEL_WHITE;
+            if(whiteB) pen_line(pen, sx, sy + 2, sx + 1, sy + 2);
+        }
+        if(tiles.u == WALL_TILE) {
+            pen->color = PIXEL_BLACK;
+            pen_line(pen, sx + 1, sy, sx + 1, sy + 1);
+            pen->color = PIXEL_WHITE;
+            if(whiteB) pen_line(pen, sx + 2, sy, sx + 2, sy + 1);
+        }
+    }
+
+    if((tiles.dr != WALL_TILE) && (tiles.r == WALL_TILE) && (tiles.d == WALL_TILE)) {
+        pen->color = PIXEL_WHITE;
+        if(whiteB) pen_line(pen, ex - 1, ey - 1, ex - 1, ey);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+// Collects pixels of one color into segments: horizontal runs first, the
+// rest as vertical runs. Collected pixels are marked done. With NULL `out`
+// the segments are only counted.
+static uint16_t collect_segments(uint8_t* pixels, uint8_t color, WallSegment* out) {
+    uint16_t count = 0;
+    uint8_t x, y, end;
+
+    for(y = 0; y < PIXELS_Y; y++) {
+        for(x = 0; x < PIXELS_X; x = end + 1) {
+            end = x;
+            if(pixels[y * PIXELS_X + x] != color) continue;
+            while((end + 1 < PIXELS_X) && (pixels[y * PIXELS_X + end + 1] == color)) {
+                end++;
+            }
+            if(end == x) continue;
+
+            if(out != NULL) out[count] = (WallSegment){x, y, end, y};
+            memset(&pixels[y * PIXELS_X + x], PIXEL_DONE, end - x + 1);
+            count++;
+        }
+    }
+
+    for(x = 0; x < PIXELS_X; x++) {
+        for(y = 0; y < PIXELS_Y; y = end + 1) {
+            end = y;
+            if(pixels[y * PIXELS_X + x] != color) continue;
+            while((end + 1 < PIXELS_Y) && (pixels[(end + 1) * PIXELS_X + x] == color)) {
+                end++;
+            }
+
+            if(out != NULL) out[count] = (WallSegment){x, y, x, end};
+            for(uint8_t i = y; i <= end; i++) {
+                pixels[i * PIXELS_X + x] = PIXEL_DONE;
+            }
+            count++;
+        }
+    }
+
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+
+static void paint_walls(uint8_t* pixels, PlayGround* pg, bool whiteB) {
+    WallPen pen = {pixels, PIXEL_NONE};
+    uint8_t x, y;
+
+    memset(pixels, PIXEL_NONE, PIXELS_X * PIXELS_Y);
+    for(y = 0; y < SIZE_Y; y++) {
+        for(x = 0; x < SIZE_X; x++) {
+            if((*pg)[y][x] == WALL_TILE) paint_wall(&pen, pg, x, y, whiteB);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+static void build_outline(WallOutline* outline, PlayGround* pg, uint8_t* pixels, bool whiteB) {
+    // count first to allocate exactly, collecting consumes the painted pixels
+    paint_walls(pixels, pg, whiteB);
+    outline->blackCount = collect_segments(pixels, PIXEL_BLACK, NULL);
+    outline->whiteCount = collect_segments(pixels, PIXEL_WHITE, NULL);
+    outline->segments = malloc(sizeof(WallSegment) * (outline->blackCount + outline->whiteCount));
+
+    paint_walls(pixels, pg, whiteB);
+    collect_segments(pixels, PIXEL_BLACK, outline->segments);
+    collect_segments(pixels, PIXEL_WHITE, &outline->segments[outline->blackCount]);
+}
+
+//-----------------------------------------------------------------------------
+
+void init_wall_geometry(WallGeometry* walls) {
+    memset(walls, 0, sizeof(WallGeometry));
+}
+
+//-----------------------------------------------------------------------------
+
+void build_wall_geometry(WallGeometry* walls, PlayGround* pg) {
+    free_wall_geometry(walls);
+
+    uint8_t* pixels = malloc(PIXELS_X * PIXELS_Y);
+    build_outline(&walls->plain, pg, pixels, false);
+    build_outline(&walls->bright, pg, pixels, true);
+    free(pixels);
+
+    FURI_LOG_D(
+        TAG,
+        "Wall segments: %u plain, %u bright",
+        walls->plain.blackCount + walls->plain.whiteCount,
+        walls->bright.blackCount + walls->bright.whiteCount);
+}
+
+//-----------------------------------------------------------------------------
+
+static void copy_outline(WallOutline* dst, const WallOutline* src) {
+    const size_t size = sizeof(WallSegment) * (src->blackCount + src->whiteCount);
+
+    dst->segments = malloc(size);
+    memcpy(dst->segments, src->segments, size);
+    dst->blackCount = src->blackCount;
+    dst->whiteCount = src->whiteCount;
+}
+
+//-----------------------------------------------------------------------------
+
+void copy_wall_geometry(WallGeometry* dst, const WallGeometry* src) {
+    free_wall_geometry(dst);
+    copy_outline(&dst->plain, &src->plain);
+    copy_outline(&dst->bright, &src->bright);
+}
+
+//-----------------------------------------------------------------------------
+
+void free_wall_geometry(WallGeometry* walls) {
+    free(walls->plain.segments);
+    free(walls->bright.segments);
+    init_wall_geometry(walls);
+}
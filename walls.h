@@ -0,0 +1,35 @@
+#pragma once
+
+#include "common.h"
+
+// Bevel and outline of walls, precomputed once per level.
+//
+// Walls never change during a level, so the lines drawn around them are
+// worked out when the level loads, flattened into final pixel colors and
+// merged into as few horizontal and vertical segments as possible. Drawing
+// a frame then only replays the segment lists.
+
+typedef struct {
+    uint8_t x0;
+    uint8_t y0;
+    uint8_t x1;
+    uint8_t y1;
+} WallSegment;
+
+typedef struct {
+    WallSegment* segments;
+    uint16_t blackCount;
+    uint16_t whiteCount;
+} WallOutline;
+
+typedef struct {
+    WallOutline plain;
+    WallOutline bright; // with extra white inner line, for finished level and solution
+} WallGeometry;
+
+//-----------------------------------------------------------------------------
+
+void init_wall_geometry(WallGeometry* walls);
+void build_wall_geometry(WallGeometry* walls, PlayGround* pg);
+void copy_wall_geometry(WallGeometry* dst, const WallGeometry* src);
+void free_wall_geometry(WallGeometry* walls);